@@ -0,0 +1,439 @@
+/**
+ * a B+ tree with the interface of sjtu::map
+ */
+
+#ifndef SJTU_BTREE_MAP_HPP
+#define SJTU_BTREE_MAP_HPP
+
+#include <functional>
+#include <cstddef>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+/**
+ * how many of the sorted keys k[0, n) are not greater than x.
+ */
+template<class Key, class Compare>
+struct btree_key_search {
+	static int upper(const Key *k, int n, const Key &x) {
+		int l = 0, r = n;
+		while (l < r) {
+			int m = (l + r) >> 1;
+			if (Compare()(x, k[m])) r = m;
+			else l = m + 1;
+		}
+		return l;
+	}
+};
+
+#ifdef __SSE2__
+template<>
+struct btree_key_search<int, std::less<int>> {
+	static int upper(const int *k, int n, const int &x) { // count 4 keys at a time
+		__m128i v = _mm_set1_epi32(x);
+		int i = 0, ret = 0;
+		for (; i + 4 <= n; i += 4) {
+			__m128i gt = _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i *)(k + i)), v);
+			ret += 4 - __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(gt)));
+		}
+		for (; i < n; i++) ret += k[i] <= x;
+		return ret;
+	}
+};
+#endif
+
+/**
+ * inner nodes hold packed separator keys, leaves hold the values and are
+ * linked in key order. every insert and erase moves values inside leaves,
+ * so unlike sjtu::map it invalidates all iterators.
+ */
+template<
+	class Key,
+	class T,
+	class Compare = std::less<Key>
+> class btree_map {
+
+public:
+	class const_iterator;
+	class iterator;
+	typedef sjtu::pair<const Key, T> value_type;
+
+private:
+	enum {
+		L = sizeof(value_type) >= 64 ? 8 : 512 / sizeof(value_type), // values per leaf
+		B = sizeof(Key) >= 32 ? 16 : 512 / sizeof(Key) > 64 ? 64 : 512 / sizeof(Key) // children per inner node
+	};
+
+	struct node {
+		int n; bool is_leaf; // values in a leaf, children in an inner node
+	};
+
+	struct leaf : node {
+		leaf *pre, *nxt;
+		typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type mem[L];
+		leaf () {this->n = 0; this->is_leaf = true; pre = nxt = this;}
+		value_type * v() {return (value_type *)mem;}
+		const value_type * v() const {return (const value_type *)mem;}
+	};
+
+	struct inner : node {
+		node *ch[B];
+		typename std::aligned_storage<sizeof(Key), alignof(Key)>::type mem[B - 1];
+		inner () {this->n = 0; this->is_leaf = false;}
+		Key * k() {return (Key *)mem;}
+	};
+
+	leaf head; // the sentinel of the leaf list, also end()
+	node *rt;
+	int sz;
+
+	static bool less(const Key &a, const Key &b) {return Compare()(a, b);}
+
+	static void move_value(value_type *to, value_type *from) {
+		new(to) value_type(std::move(*from));
+		from->~value_type();
+	}
+
+	static void move_key(Key *to, Key *from) {
+		new(to) Key(std::move(*from));
+		from->~Key();
+	}
+
+	static int lower(leaf *x, const Key &k) { // first value not less than k
+		int l = 0, r = x->n;
+		while (l < r) {
+			int m = (l + r) >> 1;
+			if (less(x->v()[m].first, k)) l = m + 1;
+			else r = m;
+		}
+		return l;
+	}
+
+	static int child(inner *x, const Key &k) {
+		return btree_key_search<Key, Compare>::upper(x->k(), x->n - 1, k);
+	}
+
+	iterator locate(const Key &k) const { // return the element or end()
+		node *x = rt;
+		while (!x->is_leaf) x = ((inner *)x)->ch[child((inner *)x, k)];
+		leaf *y = (leaf *)x;
+		int i = lower(y, k);
+		if (i == y->n || less(k, y->v()[i].first)) return end();
+		return iter(y, i);
+	}
+
+	iterator successor(const Key &k) const { // the first element greater than k, or end()
+		node *x = rt;
+		while (!x->is_leaf) x = ((inner *)x)->ch[child((inner *)x, k)];
+		leaf *y = (leaf *)x;
+		int i = lower(y, k);
+		if (i < y->n && !less(k, y->v()[i].first)) i++;
+		if (i < y->n) return iter(y, i);
+		return y->nxt == &head ? end() : iter(y->nxt, 0);
+	}
+
+	// shift in inner node x: make room at key i and child i + 1, or close it
+	static void open(inner *x, int i) {
+		for (int j = x->n - 1; j > i; j--) move_key(x->k() + j, x->k() + j - 1);
+		for (int j = x->n; j > i + 1; j--) x->ch[j] = x->ch[j - 1];
+		x->n++;
+	}
+
+	static void close(inner *x, int i) {
+		x->k()[i].~Key();
+		for (int j = i; j + 1 < x->n - 1; j++) move_key(x->k() + j, x->k() + j + 1);
+		for (int j = i + 1; j + 1 < x->n; j++) x->ch[j] = x->ch[j + 1];
+		x->n--;
+	}
+
+	void split(inner *p, int i) { // p->ch[i] is full and p is not
+		open(p, i);
+		if (p->ch[i]->is_leaf) {
+			leaf *x = (leaf *)p->ch[i], *y = new leaf;
+			for (int j = L / 2; j < L; j++) move_value(y->v() + j - L / 2, x->v() + j);
+			x->n = L / 2, y->n = L - L / 2;
+			y->pre = x, y->nxt = x->nxt;
+			x->nxt->pre = y, x->nxt = y;
+			new(p->k() + i) Key(y->v()[0].first);
+			p->ch[i + 1] = y;
+		}
+		else {
+			inner *x = (inner *)p->ch[i], *y = new inner;
+			for (int j = B / 2; j < B; j++) y->ch[j - B / 2] = x->ch[j];
+			for (int j = B / 2; j < B - 1; j++) move_key(y->k() + j - B / 2, x->k() + j);
+			move_key(p->k() + i, x->k() + B / 2 - 1);
+			x->n = B / 2, y->n = B - B / 2;
+			p->ch[i + 1] = y;
+		}
+	}
+
+	static bool full(node *x) {return x->n == (x->is_leaf ? (int)L : (int)B);}
+
+	static bool minimal(node *x) {return x->n <= (x->is_leaf ? (int)L / 2 : (int)B / 2);}
+
+	int fix(inner *p, int i) { // p->ch[i] is minimal: refill it from a sibling, return its new index
+		node *c = p->ch[i];
+		if (i && !minimal(p->ch[i - 1])) { // borrow from the left
+			if (c->is_leaf) {
+				leaf *x = (leaf *)c, *s = (leaf *)p->ch[i - 1];
+				for (int j = x->n; j > 0; j--) move_value(x->v() + j, x->v() + j - 1);
+				move_value(x->v(), s->v() + --s->n);
+				x->n++;
+				p->k()[i - 1].~Key();
+				new(p->k() + i - 1) Key(x->v()[0].first);
+			}
+			else {
+				inner *x = (inner *)c, *s = (inner *)p->ch[i - 1];
+				for (int j = x->n - 1; j > 0; j--) move_key(x->k() + j, x->k() + j - 1);
+				for (int j = x->n; j > 0; j--) x->ch[j] = x->ch[j - 1];
+				move_key(x->k(), p->k() + i - 1);
+				move_key(p->k() + i - 1, s->k() + s->n - 2);
+				x->ch[0] = s->ch[--s->n];
+				x->n++;
+			}
+			return i;
+		}
+		if (i + 1 < p->n && !minimal(p->ch[i + 1])) { // borrow from the right
+			if (c->is_leaf) {
+				leaf *x = (leaf *)c, *s = (leaf *)p->ch[i + 1];
+				move_value(x->v() + x->n++, s->v());
+				for (int j = 0; j + 1 < s->n; j++) move_value(s->v() + j, s->v() + j + 1);
+				s->n--;
+				p->k()[i].~Key();
+				new(p->k() + i) Key(s->v()[0].first);
+			}
+			else {
+				inner *x = (inner *)c, *s = (inner *)p->ch[i + 1];
+				move_key(x->k() + x->n - 1, p->k() + i);
+				x->ch[x->n++] = s->ch[0];
+				move_key(p->k() + i, s->k());
+				for (int j = 0; j + 1 < s->n - 1; j++) move_key(s->k() + j, s->k() + j + 1);
+				for (int j = 0; j + 1 < s->n; j++) s->ch[j] = s->ch[j + 1];
+				s->n--;
+			}
+			return i;
+		}
+		if (i) i--;
+		merge(p, i);
+		return i;
+	}
+
+	void merge(inner *p, int i) { // p->ch[i + 1] into p->ch[i]
+		if (p->ch[i]->is_leaf) {
+			leaf *x = (leaf *)p->ch[i], *y = (leaf *)p->ch[i + 1];
+			for (int j = 0; j < y->n; j++) move_value(x->v() + x->n + j, y->v() + j);
+			x->n += y->n;
+			x->nxt = y->nxt, y->nxt->pre = x;
+			delete y;
+		}
+		else {
+			inner *x = (inner *)p->ch[i], *y = (inner *)p->ch[i + 1];
+			new(x->k() + x->n - 1) Key(p->k()[i]);
+			for (int j = 0; j < y->n - 1; j++) move_key(x->k() + x->n + j, y->k() + j);
+			for (int j = 0; j < y->n; j++) x->ch[x->n + j] = y->ch[j];
+			x->n += y->n;
+			delete y;
+		}
+		close(p, i);
+	}
+
+	void free_node(node *x) {
+		if (x->is_leaf) {
+			leaf *y = (leaf *)x;
+			for (int i = 0; i < y->n; i++) y->v()[i].~value_type();
+			delete y;
+		}
+		else {
+			inner *y = (inner *)x;
+			for (int i = 0; i < y->n; i++) free_node(y->ch[i]);
+			for (int i = 0; i < y->n - 1; i++) y->k()[i].~Key();
+			delete y;
+		}
+	}
+
+	template <class... Args>
+	pair<iterator, bool> insert_(const Key &k, Args&&... args) {
+		if (full(rt)) {
+			inner *x = new inner;
+			x->ch[0] = rt, x->n = 1;
+			split(x, 0);
+			rt = x;
+		}
+		node *x = rt;
+		while (!x->is_leaf) {
+			inner *p = (inner *)x;
+			int i = child(p, k);
+			if (full(p->ch[i])) {
+				split(p, i);
+				if (!less(k, p->k()[i])) i++;
+			}
+			x = p->ch[i];
+		}
+		leaf *y = (leaf *)x;
+		int i = lower(y, k);
+		if (i < y->n && !less(k, y->v()[i].first)) return {iter(y, i), 0};
+		for (int j = y->n; j > i; j--) move_value(y->v() + j, y->v() + j - 1);
+		new(y->v() + i) value_type(std::forward<Args>(args)...);
+		y->n++, sz++;
+		return {iter(y, i), 1};
+	}
+
+	size_t erase_(const Key &k) {
+		node *x = rt;
+		while (!x->is_leaf) {
+			inner *p = (inner *)x;
+			int i = child(p, k);
+			if (minimal(p->ch[i])) {
+				i = fix(p, i);
+				if (p == rt && p->n == 1) { // the root lost its last key
+					rt = p->ch[0];
+					delete p;
+					x = rt;
+					continue;
+				}
+			}
+			x = p->ch[i];
+		}
+		leaf *y = (leaf *)x;
+		int i = lower(y, k);
+		if (i == y->n || less(k, y->v()[i].first)) return 0;
+		y->v()[i].~value_type();
+		for (int j = i; j + 1 < y->n; j++) move_value(y->v() + j, y->v() + j + 1);
+		y->n--, sz--;
+		return 1;
+	}
+
+	void shared_construct() {
+		sz = 0;
+		leaf *x = new leaf;
+		head.pre = head.nxt = x;
+		x->pre = x->nxt = &head;
+		rt = x;
+	}
+
+public:
+	class iterator {
+		friend btree_map;
+	private:
+		leaf *x, *e; int i;
+	public:
+		iterator() {}
+		iterator(leaf *y, int j, leaf *z) : x(y), e(z), i(j) {}
+		iterator(const iterator &other) : x(other.x), e(other.e), i(other.i) {}
+		iterator & operator++() {
+			if (x == e) throw invalid_iterator();
+			if (++i == x->n) x = x->nxt, i = 0;
+			return *this;
+		}
+		iterator operator++(int) {
+			iterator ret = *this;
+			++(*this);
+			return ret;
+		}
+		iterator & operator--() {
+			if (i) {i--; return *this;}
+			leaf *y = x->pre;
+			while (y != e && !y->n) y = y->pre;
+			if (y == e) throw invalid_iterator();
+			x = y, i = y->n - 1;
+			return *this;
+		}
+		iterator operator--(int) {
+			iterator ret = *this;
+			--(*this);
+			return ret;
+		}
+		value_type & operator*() const {if (x == e) throw invalid_iterator(); return x->v()[i];}
+		value_type* operator->() const noexcept {return x->v() + i;}
+		bool operator==(const iterator &rhs) const {return x == rhs.x && i == rhs.i;}
+		bool operator!=(const iterator &rhs) const {return !(*this == rhs);}
+	};
+
+	class const_iterator {
+		private:
+			iterator x;
+		public:
+			const_iterator() {}
+			const_iterator(const iterator &other) : x(other) {}
+			const_iterator(const const_iterator &other) : x(other.x) {}
+			const_iterator & operator ++ ()  {++x; return *this;}
+			const_iterator operator ++ (int) {const_iterator ret(*this); ++x; return ret;}
+			const_iterator & operator -- ()  {--x; return *this;}
+			const_iterator operator -- (int) {const_iterator ret(*this); --x; return ret;}
+			const value_type & operator*() const {return *x;}
+			const value_type* operator->() const noexcept {return &(*x);}
+			bool operator==(const const_iterator &rhs) const {return x == rhs.x;}
+			bool operator!=(const const_iterator &rhs) const {return x != rhs.x;}
+			friend bool operator==(const const_iterator &lhs, const iterator &rhs) {return lhs.x == rhs;}
+			friend bool operator==(const iterator &lhs, const const_iterator &rhs) {return lhs == rhs.x;}
+			friend bool operator!=(const const_iterator &lhs, const iterator &rhs) {return lhs.x != rhs;}
+			friend bool operator!=(const iterator &lhs, const const_iterator &rhs) {return lhs != rhs.x;}
+	};
+
+	inline iterator iter(leaf *x, int i) const {
+		return iterator(x, i, const_cast<leaf *>(&head));
+	}
+	void clear() {
+		free_node(rt);
+		shared_construct();
+	}
+	btree_map() {
+		shared_construct();
+	}
+	btree_map(const btree_map &other) {
+		shared_construct();
+		for (const value_type &v : other) insert(v);
+	}
+	btree_map & operator=(const btree_map &other) {
+		if (this != &other) {
+			clear();
+			for (const value_type &v : other) insert(v);
+		}
+		return *this;
+	}
+	~btree_map() {
+		free_node(rt);
+	}
+	T & at(const Key &key) {
+		iterator it = locate(key);
+		if (it == end()) throw index_out_of_bound();
+		return it->second;
+	}
+	const T & at(const Key &key) const {return const_cast<btree_map *>(this)->at(key);}
+	T & operator[](const Key &key) { // T() is built in place, and only if key is absent
+		return insert_(key, std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>()).first->second;
+	}
+	const T & operator[](const Key &key) const {return at(key);}
+	iterator begin() const {return sz ? iter(head.nxt, 0) : end();}
+	const_iterator cbegin() const {return const_iterator(begin());}
+	iterator end() const {return iter(const_cast<leaf *>(&head), 0);}
+	const_iterator cend() const {return const_iterator(end());}
+	bool empty() const {return sz == 0;}
+	int size() const {return sz;}
+	pair<iterator, bool> insert(const value_type &value) {return insert_(value.first, value);}
+	/**
+	 * erase the element at pos, and return the iterator to the one after it,
+	 * since every other iterator is invalidated.
+	 */
+	iterator erase(iterator pos) {
+		if (&head != pos.e || pos.x == &head) throw invalid_iterator();
+		Key k(pos->first);
+		erase_(k);
+		return successor(k);
+	}
+	size_t count(const Key &key) const {return locate(key) != end();}
+	iterator find(const Key &key) {return locate(key);}
+	const_iterator find(const Key &key) const {return locate(key);}
+};
+}
+
+#endif
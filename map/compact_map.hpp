@@ -0,0 +1,402 @@
+/**
+ * a splay tree with the interface of sjtu::map, in a compact node layout
+ */
+
+#ifndef SJTU_COMPACT_MAP_HPP
+#define SJTU_COMPACT_MAP_HPP
+
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+/**
+ * the links of a compact_map node, as 32-bit indices; 0 is none.
+ * the threaded layout also keeps the neighbours in key order.
+ */
+template<bool Threaded>
+struct compact_links {
+	uint32_t c[2], fa;
+};
+
+template<>
+struct compact_links<true> {
+	uint32_t c[2], fa;
+	uint32_t pre, nxt;
+};
+
+/**
+ * nodes live in slabs and refer to each other by 32-bit indices, with the
+ * value aligned right after the links: 12 bytes of links instead of the 48
+ * of sjtu::map, 20 with Threaded. without the thread, the neighbour of a
+ * node is found through the tree.
+ * nodes never move, so iterators stay valid until their element is erased.
+ * at most 2^32 - 17 elements.
+ */
+template<
+	class Key,
+	class T,
+	class Compare = std::less<Key>,
+	bool Threaded = false
+> class compact_map {
+
+public:
+	class const_iterator;
+	class iterator;
+	typedef sjtu::pair<const Key, T> value_type;
+
+private:
+	struct node : compact_links<Threaded> {
+		typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type mem;
+		value_type & v() {return *(value_type *)&mem;}
+		const value_type & v() const {return *(const value_type *)&mem;}
+	};
+
+	// index i lives at v = i + 15: the first slabs double from 16 nodes to
+	// 32768, the rest hold 65536 each, so a small map stays small and a big
+	// one wastes little
+	enum {G = 12, S = 16};
+
+	node **slab; size_t nslab, slabcap;
+	uint32_t used, freed; // indices handed out so far, and the free list through c[0]
+	uint32_t rt, lo, hi; // the root, the least and the greatest
+	int sz;
+
+	static bool less(const Key &a, const Key &b) {return Compare()(a, b);}
+
+	static size_t slab_of(uint32_t v) {return v < (1u << S) ? 27 - __builtin_clz(v) : G + (v >> S) - 1;}
+
+	static size_t slab_size(size_t j) {return j < G ? (size_t)16 << j : (size_t)1 << S;}
+
+	node & N(uint32_t i) const {
+		uint32_t v = i + 15;
+		if (v < (1u << S)) {
+			int j = 27 - __builtin_clz(v);
+			return slab[j][v - (16u << j)];
+		}
+		return slab[G + (v >> S) - 1][v & ((1u << S) - 1)];
+	}
+
+	uint32_t New() { // an index with no value yet
+		uint32_t x = freed;
+		if (x) {
+			freed = N(x).c[0];
+			return x;
+		}
+		x = ++used;
+		size_t j = slab_of(x + 15);
+		if (j == nslab) {
+			if (nslab == slabcap) {
+				slabcap = slabcap ? slabcap * 2 : 16;
+				node **s = new node*[slabcap];
+				for (size_t k = 0; k < nslab; k++) s[k] = slab[k];
+				delete [] slab;
+				slab = s;
+			}
+			slab[nslab++] = (node *)operator new(sizeof(node) * slab_size(j));
+		}
+		return x;
+	}
+
+	void Del(uint32_t x) {
+		N(x).v().~value_type();
+		N(x).c[0] = freed, freed = x;
+	}
+
+	void free_all() {
+		for (uint32_t x = lo; x; ) {
+			uint32_t y = next(x);
+			N(x).v().~value_type();
+			x = y;
+		}
+		for (size_t j = 0; j < nslab; j++) operator delete(slab[j]);
+		delete [] slab;
+	}
+
+	void shared_construct() {
+		slab = NULL; nslab = slabcap = 0;
+		used = freed = 0;
+		rt = lo = hi = 0;
+		sz = 0;
+	}
+
+	uint32_t next(uint32_t x) const { // the successor of x, or 0
+		return next_(x, std::integral_constant<bool, Threaded>());
+	}
+	uint32_t next_(uint32_t x, std::true_type) const {return N(x).nxt;}
+	uint32_t next_(uint32_t x, std::false_type) const {
+		uint32_t y = N(x).c[1];
+		if (y) {
+			while (N(y).c[0]) y = N(y).c[0];
+			return y;
+		}
+		while (N(x).fa && N(N(x).fa).c[1] == x) x = N(x).fa;
+		return N(x).fa;
+	}
+
+	uint32_t prev(uint32_t x) const { // the predecessor of x, or 0
+		return prev_(x, std::integral_constant<bool, Threaded>());
+	}
+	uint32_t prev_(uint32_t x, std::true_type) const {return N(x).pre;}
+	uint32_t prev_(uint32_t x, std::false_type) const {
+		uint32_t y = N(x).c[0];
+		if (y) {
+			while (N(y).c[1]) y = N(y).c[1];
+			return y;
+		}
+		while (N(x).fa && N(N(x).fa).c[0] == x) x = N(x).fa;
+		return N(x).fa;
+	}
+
+	void thread(uint32_t x, uint32_t p, uint32_t n) { // x between p and n in key order
+		thread_(x, p, n, std::integral_constant<bool, Threaded>());
+	}
+	void thread_(uint32_t x, uint32_t p, uint32_t n, std::true_type) {
+		N(x).pre = p, N(x).nxt = n;
+		if (p) N(p).nxt = x;
+		if (n) N(n).pre = x;
+	}
+	void thread_(uint32_t, uint32_t, uint32_t, std::false_type) {}
+
+	void unthread(uint32_t x) { // x out of the key order
+		unthread_(x, std::integral_constant<bool, Threaded>());
+	}
+	void unthread_(uint32_t x, std::true_type) {
+		uint32_t p = N(x).pre, n = N(x).nxt;
+		if (p) N(p).nxt = n;
+		if (n) N(n).pre = p;
+	}
+	void unthread_(uint32_t, std::false_type) {}
+
+	void setc(uint32_t x, uint32_t ch, int d) {
+		N(x).c[d] = ch;
+		if (ch) N(ch).fa = x;
+	}
+
+	int dir(uint32_t x) const {return N(N(x).fa).c[1] == x;}
+
+	void rot(uint32_t x) {
+		uint32_t f = N(x).fa, g = N(f).fa;
+		int d = dir(x);
+		if (g) setc(g, x, dir(f));
+		else N(x).fa = 0, rt = x;
+		setc(f, N(x).c[!d], d);
+		setc(x, f, !d);
+	}
+
+	uint32_t splay(uint32_t x, uint32_t top = 0) { // until the parent of x is top
+		while (N(x).fa != top) {
+			uint32_t f = N(x).fa;
+			if (N(f).fa != top) rot(dir(x) == dir(f) ? f : x);
+			rot(x);
+		}
+		return x;
+	}
+
+	uint32_t search(const Key &k, uint32_t &last) const { // the node of k or 0, and the last node on the path
+		uint32_t x = rt;
+		last = 0;
+		while (x) {
+			last = x;
+			if (less(k, N(x).v().first)) x = N(x).c[0];
+			else if (less(N(x).v().first, k)) x = N(x).c[1];
+			else return x;
+		}
+		return 0;
+	}
+
+	uint32_t get(const Key &k) { // the node of k or 0, splayed
+		uint32_t last, x = search(k, last);
+		if (last) splay(last);
+		return x;
+	}
+
+	template <class... Args>
+	pair<iterator, bool> insert_(const Key &k, Args&&... args) {
+		uint32_t y, x = search(k, y);
+		if (x) return {iter(splay(x)), 0};
+		x = New();
+		node &n = N(x);
+		new(&n.mem) value_type(std::forward<Args>(args)...);
+		n.c[0] = n.c[1] = 0;
+		sz++;
+		if (!y) {
+			n.fa = 0, rt = lo = hi = x;
+			thread(x, 0, 0);
+			return {iter(x), 1};
+		}
+		int d = less(N(y).v().first, k);
+		if (Threaded) d ? thread(x, y, next(y)) : thread(x, prev(y), y);
+		setc(y, x, d);
+		if (y == hi && d) hi = x;
+		if (y == lo && !d) lo = x;
+		return {iter(splay(x)), 1};
+	}
+
+	void erase_(uint32_t x) {
+		if (x == lo) lo = next(x);
+		if (x == hi) hi = prev(x);
+		unthread(x);
+		splay(x);
+		uint32_t l = N(x).c[0], r = N(x).c[1];
+		if (l) {
+			uint32_t m = l;
+			while (N(m).c[1]) m = N(m).c[1];
+			splay(m, x);
+			setc(m, r, 1);
+			l = m;
+		}
+		else l = r;
+		rt = l;
+		if (l) N(l).fa = 0;
+		Del(x);
+		sz--;
+	}
+
+	uint32_t build(uint32_t l, uint32_t r) { // fresh indices [l, r) in key order as a balanced tree
+		if (l == r) return 0;
+		uint32_t m = l + (r - l) / 2;
+		setc(m, build(l, m), 0);
+		setc(m, build(m + 1, r), 1);
+		return m;
+	}
+
+	void copy(const compact_map &other) { // into an empty map: indices 1..n in key order, so nodes are contiguous
+		if (!other.sz) return;
+		uint32_t n = 0;
+		for (uint32_t x = other.lo; x; x = other.next(x)) {
+			uint32_t y = New();
+			new(&N(y).mem) value_type(other.N(x).v());
+			n = y;
+		}
+		sz = other.sz;
+		rt = build(1, n + 1);
+		N(rt).fa = 0;
+		lo = 1, hi = n;
+		if (Threaded) for (uint32_t i = 1; i <= n; i++) thread(i, i - 1, i < n ? i + 1 : 0);
+	}
+
+public:
+	class iterator {
+		friend compact_map;
+	private:
+		const compact_map *m; uint32_t i;
+	public:
+		iterator() {}
+		iterator(const compact_map *y, uint32_t j) : m(y), i(j) {}
+		iterator(const iterator &other) : m(other.m), i(other.i) {}
+		iterator & operator++() {
+			if (!i) throw invalid_iterator();
+			i = m->next(i);
+			return *this;
+		}
+		iterator operator++(int) {
+			iterator ret = *this;
+			++(*this);
+			return ret;
+		}
+		iterator & operator--() {
+			uint32_t j = i ? m->prev(i) : m->hi;
+			if (!j) throw invalid_iterator();
+			i = j;
+			return *this;
+		}
+		iterator operator--(int) {
+			iterator ret = *this;
+			--(*this);
+			return ret;
+		}
+		value_type & operator*() const {if (!i) throw invalid_iterator(); return m->N(i).v();}
+		value_type* operator->() const noexcept {return &m->N(i).v();}
+		bool operator==(const iterator &rhs) const {return i == rhs.i && m == rhs.m;}
+		bool operator!=(const iterator &rhs) const {return !(*this == rhs);}
+	};
+
+	class const_iterator {
+		private:
+			iterator x;
+		public:
+			const_iterator() {}
+			const_iterator(const iterator &other) : x(other) {}
+			const_iterator(const const_iterator &other) : x(other.x) {}
+			const_iterator & operator ++ ()  {++x; return *this;}
+			const_iterator operator ++ (int) {const_iterator ret(*this); ++x; return ret;}
+			const_iterator & operator -- ()  {--x; return *this;}
+			const_iterator operator -- (int) {const_iterator ret(*this); --x; return ret;}
+			const value_type & operator*() const {return *x;}
+			const value_type* operator->() const noexcept {return &(*x);}
+			bool operator==(const const_iterator &rhs) const {return x == rhs.x;}
+			bool operator!=(const const_iterator &rhs) const {return x != rhs.x;}
+			friend bool operator==(const const_iterator &lhs, const iterator &rhs) {return lhs.x == rhs;}
+			friend bool operator==(const iterator &lhs, const const_iterator &rhs) {return lhs == rhs.x;}
+			friend bool operator!=(const const_iterator &lhs, const iterator &rhs) {return lhs.x != rhs;}
+			friend bool operator!=(const iterator &lhs, const const_iterator &rhs) {return lhs != rhs.x;}
+	};
+
+	inline iterator iter(uint32_t x) const {
+		return iterator(this, x);
+	}
+	void clear() {
+		free_all();
+		shared_construct();
+	}
+	compact_map() {
+		shared_construct();
+	}
+	compact_map(const compact_map &other) {
+		shared_construct();
+		copy(other);
+	}
+	compact_map & operator=(const compact_map &other) {
+		if (this != &other) {
+			clear();
+			copy(other);
+		}
+		return *this;
+	}
+	~compact_map() {
+		free_all();
+	}
+	/**
+	 * as in sjtu::map, the non-const lookups splay and the const ones do not.
+	 */
+	T & at(const Key &key) {
+		uint32_t x = get(key);
+		if (!x) throw index_out_of_bound();
+		return N(x).v().second;
+	}
+	const T & at(const Key &key) const {
+		uint32_t last, x = search(key, last);
+		if (!x) throw index_out_of_bound();
+		return N(x).v().second;
+	}
+	T & operator[](const Key &key) { // T() is built in place, and only if key is absent
+		return insert_(key, std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>()).first->second;
+	}
+	const T & operator[](const Key &key) const {return at(key);}
+	iterator begin() const {return iter(lo);}
+	const_iterator cbegin() const {return const_iterator(begin());}
+	iterator end() const {return iter(0);}
+	const_iterator cend() const {return const_iterator(end());}
+	bool empty() const {return sz == 0;}
+	int size() const {return sz;}
+	pair<iterator, bool> insert(const value_type &value) {return insert_(value.first, value);}
+	void erase(iterator pos) {
+		if (pos.m != this || !pos.i) throw invalid_iterator();
+		erase_(pos.i);
+	}
+	size_t count(const Key &key) {return get(key) != 0;}
+	size_t count(const Key &key) const {uint32_t last; return search(key, last) != 0;}
+	iterator find(const Key &key) {return iter(get(key));}
+	const_iterator find(const Key &key) const {uint32_t last; return iter(search(key, last));}
+};
+}
+
+#endif
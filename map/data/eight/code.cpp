@@ -0,0 +1,94 @@
+#include "map.hpp"
+#include <iostream>
+#include <cstdio>
+#include <map>
+#include <string>
+
+int last = 233;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+bool check1() { // lower_bound / upper_bound against std::map
+	sjtu::map<int, int> Q;
+	std::map<int, int> stdQ;
+	for (int i = 1; i <= 30000; i++) {
+		int x = Rand() % 100000;
+		Q[x] = i; stdQ[x] = i;
+	}
+	for (int i = 1; i <= 30000; i++) {
+		int x = Rand() % 100002 - 1;
+		auto it = Q.lower_bound(x);
+		auto stdit = stdQ.lower_bound(x);
+		if ((it == Q.end()) != (stdit == stdQ.end())) return 0;
+		if (stdit != stdQ.end() && (it->first != stdit->first || it->second != stdit->second)) return 0;
+		it = Q.upper_bound(x);
+		stdit = stdQ.upper_bound(x);
+		if ((it == Q.end()) != (stdit == stdQ.end())) return 0;
+		if (stdit != stdQ.end() && it->first != stdit->first) return 0;
+	}
+	return 1;
+}
+
+bool check2() { // const bounds and equal_range
+	sjtu::map<int, int> Q;
+	std::map<int, int> stdQ;
+	for (int i = 1; i <= 10000; i++) {
+		int x = Rand() % 30000;
+		Q[x] = i; stdQ[x] = i;
+	}
+	const sjtu::map<int, int> &cQ = Q;
+	for (int i = 1; i <= 10000; i++) {
+		int x = Rand() % 30002 - 1;
+		sjtu::map<int, int>::const_iterator it = cQ.lower_bound(x);
+		auto stdit = stdQ.lower_bound(x);
+		if ((it == cQ.cend()) != (stdit == stdQ.end())) return 0;
+		if (stdit != stdQ.end() && it->first != stdit->first) return 0;
+		auto r = Q.equal_range(x);
+		auto cr = cQ.equal_range(x);
+		int n = 0;
+		for (auto j = r.first; j != r.second; ++j) n++;
+		if (n != (int)stdQ.count(x) || r.first != cr.first || r.second != cr.second) return 0;
+		if (r.second != Q.upper_bound(x)) return 0;
+	}
+	return 1;
+}
+
+bool check3() { // range scans
+	sjtu::map<int, std::string> Q;
+	std::map<int, std::string> stdQ;
+	for (int i = 1; i <= 20000; i++) {
+		int x = Rand() % 50000;
+		Q[x] = std::to_string(x); stdQ[x] = std::to_string(x);
+	}
+	for (int i = 1; i <= 2000; i++) {
+		int a = Rand() % 50000, b = a + Rand() % 100;
+		auto it = Q.lower_bound(a);
+		auto stdit = stdQ.lower_bound(a);
+		for (auto e = Q.lower_bound(b); it != e; ++it, ++stdit)
+			if (it->second != stdit->second) return 0;
+		if (stdit != stdQ.lower_bound(b)) return 0;
+	}
+	return 1;
+}
+
+bool check4() { // bounds at both ends and on an empty map
+	sjtu::map<int, int> Q;
+	if (Q.lower_bound(0) != Q.end() || Q.upper_bound(0) != Q.end()) return 0;
+	for (int i = 1; i <= 100; i++) Q[i * 2] = i;
+	if (Q.lower_bound(-5) != Q.begin() || Q.upper_bound(1) != Q.begin()) return 0;
+	if (Q.lower_bound(201) != Q.end() || Q.upper_bound(200) != Q.end()) return 0;
+	if (Q.lower_bound(200)->second != 100) return 0;
+	auto r = Q.equal_range(7);
+	return r.first == r.second && r.first->first == 8;
+}
+
+int main() {
+	bool (*check[])() = {check1, check2, check3, check4};
+	for (int i = 0; i < 4; i++) {
+		if (check[i]()) printf("Test %d Passed!\n", i + 1);
+		else printf("Test %d Failed......\n", i + 1);
+	}
+	return 0;
+}
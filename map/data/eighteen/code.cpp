@@ -0,0 +1,114 @@
+#include "flat_map.hpp"
+#include <iostream>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+int last = 1111;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+typedef sjtu::flat_map<int, std::string> Map;
+typedef sjtu::pair<const int, std::string> value;
+
+bool same(const Map &Q, const std::map<int, std::string> &stdQ) {
+	if (Q.size() != (int)stdQ.size()) return 0;
+	auto it = Q.cbegin();
+	for (auto &p : stdQ) {
+		if (it == Q.cend() || it->first != p.first || (*it).second != p.second) return 0;
+		++it;
+	}
+	return it == Q.cend();
+}
+
+bool check1() { // batch insert: duplicates in the range, and keys already present
+	Map Q;
+	std::map<int, std::string> stdQ;
+	for (int round = 0; round < 200; round++) {
+		std::vector<value> v;
+		for (int i = Rand() % 300; i > 0; i--) {
+			int x = Rand() % 6000;
+			v.push_back(value(x, std::to_string(round) + "." + std::to_string(i)));
+		}
+		Q.insert(v.begin(), v.end());
+		for (auto &p : v) stdQ.insert(std::make_pair(p.first, p.second)); // the first one wins
+		if (!same(Q, stdQ)) return 0;
+		for (int i = 0; i < 20; i++) {
+			int x = Rand() % 6000;
+			if (Q.erase(x) != stdQ.erase(x)) return 0;
+		}
+	}
+	std::vector<value> v;
+	for (int i = 100; i > 0; i--) v.push_back(value(i % 37, std::to_string(i)));
+	Map R(v.begin(), v.end());
+	return same(Q, stdQ) && R.size() == 37 && R.at(0) == "74" && R.at(36) == "73" && R.at(1) == "75";
+}
+
+bool check2() { // a sorted range past the end is only appended; one that is not is merged
+	Map Q;
+	std::map<int, std::string> stdQ;
+	for (int round = 0; round < 100; round++) {
+		std::vector<value> v;
+		int b = stdQ.empty() ? 0 : stdQ.rbegin()->first;
+		for (int i = 1; i <= 50; i++) v.push_back(value(b + i * 2, "s"));
+		if (round % 3 == 0) v.push_back(value(b + 1, "t")); // sorted but for the last
+		if (round % 5 == 0) v.push_back(value(b + 2, "u")); // a duplicate at the end
+		Q.insert(v.begin(), v.end());
+		for (auto &p : v) stdQ.insert(std::make_pair(p.first, p.second));
+		if (!same(Q, stdQ)) return 0;
+	}
+	std::vector<value> e;
+	Q.insert(e.begin(), e.end());
+	return same(Q, stdQ);
+}
+
+bool check3() { // lower_bound, upper_bound and single inserts and erases
+	Map Q;
+	std::map<int, std::string> stdQ;
+	const Map &C = Q;
+	if (C.lower_bound(3) != C.cend() || Q.upper_bound(3) != Q.end() || C.count(1)) return 0;
+	for (int i = 0; i < 30000; i++) {
+		int x = Rand() % 5000, op = Rand() % 6;
+		if (op == 0) Q[x] = std::to_string(i), stdQ[x] = std::to_string(i);
+		else if (op == 1) {
+			auto r = Q.insert(value(x, "i"));
+			auto s = stdQ.insert(std::make_pair(x, "i"));
+			if (r.second != s.second || r.first->second != s.first->second) return 0;
+		}
+		else if (op == 2) {
+			auto it = Q.find(x);
+			if ((it == Q.end()) != !stdQ.count(x)) return 0;
+			if (it != Q.end()) Q.erase(it), stdQ.erase(x);
+		}
+		else {
+			auto a = C.lower_bound(x);
+			auto b = stdQ.lower_bound(x);
+			if ((a == C.cend()) != (b == stdQ.end()) || (a != C.cend() && a->first != b->first)) return 0;
+			auto u = Q.upper_bound(x);
+			auto w = stdQ.upper_bound(x);
+			if ((u == Q.end()) != (w == stdQ.end()) || (u != Q.end() && u->second != w->second)) return 0;
+		}
+	}
+	if (!same(Q, stdQ)) return 0;
+	for (auto p : Q) p.second += "x";
+	for (auto &p : stdQ) p.second += "x";
+	Map R(Q);
+	Q.clear();
+	Q = R;
+	try {Q.at(-1); return 0;} catch (sjtu::index_out_of_bound) {}
+	try {Q.erase(Q.end()); return 0;} catch (sjtu::invalid_iterator) {}
+	try {--Q.begin(); return 0;} catch (sjtu::invalid_iterator) {}
+	return same(Q, stdQ) && same(R, stdQ);
+}
+
+int main() {
+	bool (*check[])() = {check1, check2, check3};
+	for (int i = 0; i < 3; i++) {
+		if (check[i]()) printf("Test %d Passed!\n", i + 1);
+		else printf("Test %d Failed......\n", i + 1);
+	}
+	return 0;
+}
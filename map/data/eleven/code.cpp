@@ -0,0 +1,166 @@
+#include "map.hpp"
+#include <iostream>
+#include <cstdio>
+#include <map>
+#include <string>
+
+int last = 233333;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+template <class A, class B>
+bool same(const A &Q, const B &stdQ) {
+	if (Q.size() != (int)stdQ.size()) return 0;
+	auto it = Q.cbegin();
+	for (auto &p : stdQ) {
+		if (it == Q.cend() || it->first != p.first || it->second != p.second) return 0;
+		++it;
+	}
+	return it == Q.cend();
+}
+
+template <class A, class B>
+void fill(A &Q, B &stdQ, int n, int lo, int span) {
+	for (int i = 0; i < n; i++) {
+		int x = lo + Rand() % span;
+		Q[x] = i; stdQ[x] = i;
+	}
+}
+
+bool check1() { // merge
+	for (int t = 0; t < 50; t++) {
+		sjtu::map<int, int> Q, P;
+		std::map<int, int> stdQ, stdP;
+		fill(Q, stdQ, 2000, Rand() % 5000, 5000);
+		fill(P, stdP, 2000, Rand() % 5000, 5000);
+		Q.merge(std::move(P));
+		for (auto it = stdP.begin(); it != stdP.end(); )
+			if (stdQ.insert(*it).second) it = stdP.erase(it);
+			else ++it;
+		if (!same(Q, stdQ) || !same(P, stdP)) return 0;
+	}
+	return 1;
+}
+
+bool check2() { // union_with
+	for (int t = 0; t < 50; t++) {
+		sjtu::map<int, int> Q, P;
+		std::map<int, int> stdQ, stdP;
+		fill(Q, stdQ, 2000, Rand() % 5000, 5000);
+		fill(P, stdP, 2000, Rand() % 5000, 5000);
+		Q.union_with(P, [](int a, int b) {return a * 3 + b;});
+		for (auto &p : stdP) {
+			if (stdQ.count(p.first)) stdQ[p.first] = stdQ[p.first] * 3 + p.second;
+			else stdQ.insert(p);
+		}
+		if (!same(Q, stdQ) || !same(P, stdP)) return 0;
+	}
+	return 1;
+}
+
+bool check3() { // intersect and difference
+	for (int t = 0; t < 50; t++) {
+		sjtu::map<int, int> Q, P;
+		std::map<int, int> stdQ, stdP;
+		fill(Q, stdQ, 2000, Rand() % 5000, 5000);
+		fill(P, stdP, 2000, Rand() % 5000, 5000);
+		sjtu::map<int, int> R(Q);
+		std::map<int, int> stdR(stdQ);
+		Q.intersect(P);
+		R.difference(P);
+		for (auto it = stdQ.begin(); it != stdQ.end(); )
+			if (stdP.count(it->first)) stdR.erase(it->first), ++it;
+			else it = stdQ.erase(it);
+		if (!same(Q, stdQ) || !same(R, stdR)) return 0;
+	}
+	return 1;
+}
+
+bool check4() { // the disjoint and degenerate cases
+	sjtu::map<int, int> Q, P, E;
+	for (int i = 0; i < 1000; i++) Q[i] = i, P[i + 1000] = i;
+	Q.difference(P);
+	if (Q.size() != 1000) return 0;
+	Q.union_with(P, [](int a, int b) {return a + b;});
+	if (Q.size() != 2000 || P.size() != 1000) return 0;
+	Q.union_with(Q, [](int a, int b) {return a + b;});
+	if (Q.at(1500) != 1000) return 0;
+	Q.intersect(P);
+	if (Q.size() != 1000 || Q.begin()->first != 1000) return 0;
+	Q.merge(std::move(E));
+	Q.difference(Q);
+	Q.merge(std::move(P));
+	return Q.size() == 1000 && P.empty() && Q.at(1999) == 999;
+}
+
+int fuse = -1; // Fuse throws on the call that brings it to 0
+
+struct Fuse {
+	bool operator()(int a, int b) const {
+		if (fuse >= 0 && !fuse--) throw sjtu::runtime_error();
+		return a < b;
+	}
+};
+
+template <class A>
+bool valid(A &Q, const std::map<int, int> &stdQ) { // the iteration, and the tree through lookups
+	if (!same(Q, stdQ)) return 0;
+	for (auto &p : stdQ) if (Q.at(p.first) != p.second) return 0;
+	return Q.count(-1) == 0 && Q.count(100000) == 0;
+}
+
+bool check5() { // a throw midway loses no element
+	for (int t = 0; t < 20; t++) {
+		sjtu::map<int, int> Q, P;
+		std::map<int, int> stdQ, stdP;
+		fill(Q, stdQ, 100, 0, 300);
+		fill(P, stdP, 100, 100, 300);
+		int n = 0, stop = Rand() % 40;
+		try {
+			Q.union_with(P, [&n, stop](int a, int b) {
+				if (n++ == stop) throw sjtu::runtime_error();
+				return a + b;
+			});
+		} catch (sjtu::runtime_error) {}
+		for (auto &p : stdQ) if (!Q.count(p.first)) return 0;
+		if (Q.size() < (int)stdQ.size() || !valid(P, stdP)) return 0;
+	}
+	for (int t = 0; t < 40; t++) {
+		sjtu::map<int, int, Fuse> Q, P;
+		std::map<int, int> stdQ, stdP, stdR;
+		fill(Q, stdQ, 100, 0, 300);
+		fill(P, stdP, 100, 100, 300);
+		fuse = Rand() % 300;
+		try {
+			if (t % 4 == 0) Q.merge(std::move(P));
+			else if (t % 4 == 1) Q.union_with(P, [](int a, int b) {return a + b;});
+			else if (t % 4 == 2) Q.intersect(P);
+			else Q.difference(P);
+		} catch (sjtu::runtime_error) {}
+		fuse = -1;
+		for (auto &p : Q) stdR[p.first] = p.second;
+		if (!valid(Q, stdR)) return 0;
+		stdR.clear();
+		for (auto &p : P) stdR[p.first] = p.second;
+		if (!valid(P, stdR)) return 0;
+		if (t % 4 == 0) { // every element is in one of the two
+			for (auto &p : stdQ) if (!Q.count(p.first)) return 0;
+			if (Q.size() + P.size() != (int)(stdQ.size() + stdP.size())) return 0;
+		}
+		if (t % 4 == 1 || t % 4 == 3) for (auto &p : stdQ) if (!Q.count(p.first) && !stdP.count(p.first)) return 0;
+		Q[-1] = 0;
+		if (Q.begin()->first != -1) return 0;
+	}
+	return 1;
+}
+
+int main() {
+	bool (*check[])() = {check1, check2, check3, check4, check5};
+	for (int i = 0; i < 5; i++) {
+		if (check[i]()) printf("Test %d Passed!\n", i + 1);
+		else printf("Test %d Failed......\n", i + 1);
+	}
+	return 0;
+}
@@ -0,0 +1,177 @@
+#include "compact_map.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <map>
+#include <string>
+
+class Integer {
+public:
+	static int counter;
+	int val;
+	
+	Integer(int val) : val(val) {
+		counter++;
+	}
+
+	Integer(const Integer &rhs) {
+		val = rhs.val;
+		counter++;
+	}
+
+	Integer& operator = (const Integer &rhs) {
+		assert(false);
+	}
+
+	~Integer() {
+		counter--;
+	}
+};
+
+int Integer::counter = 0;
+
+class Compare {
+public:
+	bool operator () (const Integer &lhs, const Integer &rhs) const {
+		return lhs.val < rhs.val;
+	}
+};
+
+template <bool Threaded>
+void tester(void) { // the workload of one, on both layouts; 100000 keys reach past the 65536th index
+	//	test: constructor
+	sjtu::compact_map<Integer, std::string, Compare, Threaded> map;
+	//	test: empty(), size()
+	assert(map.empty() && map.size() == 0);
+	//	test: operator[], insert()
+	for (int i = 0; i < 100000; ++i) {
+		std::string string = "";
+		for (int number = i; number; number /= 10) {
+			char digit = '0' + number % 10;
+			string = digit + string;
+		}
+		if (i & 1) {
+			map[Integer(i)] = string;
+			auto result = map.insert(sjtu::pair<Integer, std::string>(Integer(i), string));
+			assert(!result.second);
+		} else {
+			auto result = map.insert(sjtu::pair<Integer, std::string>(Integer(i), string));
+			assert(result.second);
+		}
+	}
+	//	test: count(), find(), erase()
+	for (int i = 0; i < 100000; ++i) {
+		if (i > 1896 && i <= 2016) {
+			continue;
+		}
+		assert(map.count(Integer(i)) == 1);
+		assert(map.find(Integer(i)) != map.end());
+		map.erase(map.find(Integer(i)));
+	}
+	//	test: constructor, operator=, clear();
+	for (int i = 0; i < (int)map.size(); ++i) {
+		sjtu::compact_map<Integer, std::string, Compare, Threaded> copy(map);
+		map.clear();
+		std::cout << map.size() << " " << copy.size() << " ";
+		map = copy;
+		copy.clear();
+		std::cout << map.size() << " " << copy.size() << " ";
+		copy = map;
+		map.clear();
+		std::cout << map.size() << " " << copy.size() << " ";
+		map = copy;
+		copy.clear();
+		std::cout << map.size() << " " << copy.size() << " ";
+	}
+	std::cout << std::endl;
+	//	test: const_iterator, cbegin(), cend(), operator++, at()
+	typename sjtu::compact_map<Integer, std::string, Compare, Threaded>::const_iterator const_iterator;
+	const_iterator = map.cbegin();
+	while (const_iterator != map.cend()) {
+		const Integer integer(const_iterator->first);
+		const_iterator++;
+		std::cout << map.at(integer) << " ";
+	}
+	std::cout << std::endl;
+	//	test: iterator, operator--, operator->
+	typename sjtu::compact_map<Integer, std::string, Compare, Threaded>::iterator iterator;
+	iterator = map.end();
+	while (true) {
+		typename sjtu::compact_map<Integer, std::string, Compare, Threaded>::iterator peek = iterator;
+		if (peek == map.begin()) {
+			std::cout << std::endl;
+			break;
+		}
+		std::cout << (--iterator)->second << " ";
+	}
+	//	test: erase()
+	while (map.begin() != map.end()) {
+		map.erase(map.begin());
+	}
+	assert(map.empty() && map.size() == 0);
+	//	test: operator[]
+	for (int i = 0; i < 100000; ++i) {
+		std::cout << map[Integer(i)];
+	}
+	std::cout << map.size() << std::endl;
+}
+
+int last = 1357;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+template <bool Threaded>
+bool check() { // random churn against std::map, with 200000 indices in use and freed ones reused
+	sjtu::compact_map<int, int, std::less<int>, Threaded> Q;
+	std::map<int, int> stdQ;
+	for (int i = 1; i <= 600000; i++) {
+		int x = Rand() % 300000;
+		if (i <= 200000 || Rand() % 2) Q[x] = i, stdQ[x] = i;
+		else {
+			auto it = Q.find(x);
+			if ((it == Q.end()) != !stdQ.count(x)) return 0;
+			if (it != Q.end()) Q.erase(it), stdQ.erase(x);
+		}
+		if (i % 100000 == 0) {
+			const sjtu::compact_map<int, int, std::less<int>, Threaded> C(Q);
+			if (Q.size() != (int)stdQ.size() || C.size() != Q.size()) return 0;
+			auto it = Q.begin();
+			auto jt = C.cbegin();
+			for (auto &p : stdQ) {
+				if (it->first != p.first || it->second != p.second || jt->second != p.second) return 0;
+				++it, ++jt;
+			}
+			if (it != Q.end() || jt != C.cend()) return 0;
+			for (auto p = stdQ.rbegin(); p != stdQ.rend(); ++p)
+				if ((--it)->first != p->first) return 0;
+		}
+	}
+	return 1;
+}
+
+int made; // the values built by default
+
+struct Made {
+	int v;
+	Made() : v(0) {made++;}
+};
+
+template <bool Threaded>
+bool check_index() { // operator[] builds a value only for a new key
+	sjtu::compact_map<int, Made, std::less<int>, Threaded> Q;
+	made = 0;
+	for (int i = 0; i < 10000; i++) Q[i * 2].v = i;
+	for (int i = 0; i < 20000; i++) Q[i].v++; // the odd keys are new
+	return made == 20000 && Q.size() == 20000 && Q[10].v == 6 && Q[11].v == 1 && made == 20000;
+}
+
+int main(void) {
+	tester<false>();
+	tester<true>();
+	std::cout << Integer::counter << std::endl;
+	printf("Test %s\n", check<false>() ? "1 Passed!" : "1 Failed......");
+	printf("Test %s\n", check<true>() ? "2 Passed!" : "2 Failed......");
+	printf("Test %s\n", check_index<false>() && check_index<true>() ? "3 Passed!" : "3 Failed......");
+}
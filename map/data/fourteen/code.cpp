@@ -0,0 +1,134 @@
+#include "btree_map.hpp"
+#include <iostream>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <string>
+
+int last = 2468;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+template <class A, class B>
+bool same(const A &Q, const B &stdQ) { // forwards and backwards
+	if (Q.size() != (int)stdQ.size()) return 0;
+	auto it = Q.cbegin();
+	for (auto &p : stdQ) {
+		if (it == Q.cend() || it->first != p.first || it->second != p.second) return 0;
+		++it;
+	}
+	if (it != Q.cend()) return 0;
+	for (auto p = stdQ.rbegin(); p != stdQ.rend(); ++p)
+		if ((--it)->first != p->first) return 0;
+	return it == Q.cbegin();
+}
+
+/**
+ * random inserts and erases, then erase nearly all and grow again: leaves
+ * and inner nodes split on the way up and borrow or merge on the way down.
+ */
+template <class Key, class Compare, class F>
+bool workload(F key, int range) {
+	sjtu::btree_map<Key, int, Compare> Q;
+	std::map<Key, int, Compare> stdQ;
+	for (int i = 1; i <= 100000; i++) {
+		Key x = key(Rand() % range);
+		Q[x] = i, stdQ[x] = i;
+	}
+	if (!same(Q, stdQ)) return 0;
+	for (int i = 1; i <= 300000; i++) {
+		Key x = key(Rand() % range);
+		int op = Rand() % 4;
+		if (op == 0) Q[x] = i, stdQ[x] = i;
+		else if (op == 1) {
+			auto it = Q.find(x);
+			if ((it == Q.end()) != !stdQ.count(x)) return 0;
+			if (it != Q.end()) {
+				auto nx = stdQ.erase(stdQ.find(x));
+				it = Q.erase(it);
+				if ((it == Q.end()) != (nx == stdQ.end()) || (it != Q.end() && it->first != nx->first)) return 0;
+			}
+		}
+		else if (op == 2) {
+			if (Q.count(x) != stdQ.count(x)) return 0;
+			if (stdQ.count(x) && Q.at(x) != stdQ[x]) return 0;
+		}
+		else {
+			auto r = Q.insert(sjtu::pair<const Key, int>(x, -i));
+			auto s = stdQ.insert(std::make_pair(x, -i));
+			if (r.second != s.second || r.first->second != s.first->second) return 0;
+		}
+		if (i % 50000 == 0 && !same(Q, stdQ)) return 0;
+	}
+	while (Q.size() > 10) {
+		auto it = Q.find(stdQ.begin()->first);
+		if (Rand() % 2) it = Q.find(stdQ.rbegin()->first);
+		stdQ.erase(it->first);
+		Q.erase(it);
+		if (Q.size() % 10007 == 0 && !same(Q, stdQ)) return 0;
+	}
+	if (!same(Q, stdQ)) return 0;
+	for (int i = 1; i <= 50000; i++) {
+		Key x = key(Rand() % range);
+		Q[x] = i, stdQ[x] = i;
+	}
+	return same(Q, stdQ);
+}
+
+bool check1() { // int keys with std::less: the SSE2 search in inner nodes
+	return workload<int, std::less<int>>([](int x) {return x * 7 - 300000;}, 200000);
+}
+
+bool check2() { // the generic search: other comparators, long keys
+	return workload<int, std::greater<int>>([](int x) {return x;}, 200000)
+		&& workload<std::string, std::less<std::string>>([](int x) {return std::to_string(x) + "-key";}, 100000);
+}
+
+bool check3() { // copy, assignment, clear and the exceptions
+	sjtu::btree_map<int, std::string> Q;
+	std::map<int, std::string> stdQ;
+	for (int i = 0; i < 20000; i++) {
+		int x = Rand() % 50000;
+		Q[x] = std::to_string(x), stdQ[x] = std::to_string(x);
+	}
+	sjtu::btree_map<int, std::string> R(Q), S;
+	S = Q;
+	Q.clear();
+	if (!Q.empty() || Q.begin() != Q.end() || !same(R, stdQ) || !same(S, stdQ)) return 0;
+	try {Q.at(1); return 0;} catch (sjtu::index_out_of_bound) {}
+	try {Q.erase(Q.end()); return 0;} catch (sjtu::invalid_iterator) {}
+	try {Q.erase(R.begin()); return 0;} catch (sjtu::invalid_iterator) {}
+	try {--Q.begin(); return 0;} catch (sjtu::invalid_iterator) {}
+	try {++R.end(); return 0;} catch (sjtu::invalid_iterator) {}
+	S = S;
+	return same(S, stdQ);
+}
+
+int made; // the values built by default
+
+struct Made {
+	int v;
+	Made() : v(0) {made++;}
+	Made(int v) : v(v) {}
+};
+
+bool check4() { // operator[] builds a value only for a new key
+	sjtu::btree_map<int, Made> Q;
+	for (int i = 0; i < 10000; i++) Q[i * 2].v = i;
+	if (made != 10000) return 0;
+	for (int i = 0; i < 20000; i++) Q[i].v++; // the odd keys are new
+	if (made != 20000 || Q.size() != 20000) return 0;
+	const sjtu::btree_map<int, Made> &C = Q;
+	return C[10].v == 6 && C[11].v == 1 && made == 20000;
+}
+
+int main() {
+	bool (*check[])() = {check1, check2, check3, check4};
+	for (int i = 0; i < 4; i++) {
+		if (check[i]()) printf("Test %d Passed!\n", i + 1);
+		else printf("Test %d Failed......\n", i + 1);
+	}
+	return 0;
+}
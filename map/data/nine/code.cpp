@@ -0,0 +1,83 @@
+#include "map.hpp"
+#include <iostream>
+#include <cstdio>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+int last = 2333;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+bool check1() { // rank and select against a sorted array
+	sjtu::map<int, int> Q;
+	std::map<int, int> stdQ;
+	for (int i = 1; i <= 30000; i++) {
+		int x = Rand() % 100000;
+		Q[x] = i; stdQ[x] = i;
+	}
+	std::vector<int> keys;
+	for (auto &p : stdQ) keys.push_back(p.first);
+	for (int i = 1; i <= 30000; i++) {
+		int x = Rand() % 100002 - 1;
+		if (Q.rank(x) != std::lower_bound(keys.begin(), keys.end(), x) - keys.begin()) return 0;
+		int k = Rand() % keys.size();
+		if (Q.select(k)->first != keys[k]) return 0;
+	}
+	return Q.select(Q.size()) == Q.end();
+}
+
+bool check2() { // sizes stay right through erase, copy and the const versions
+	sjtu::map<int, int> Q;
+	std::map<int, int> stdQ;
+	for (int i = 1; i <= 20000; i++) {
+		int x = Rand() % 10000;
+		if (i % 3) Q[x] = i, stdQ[x] = i;
+		else if (Q.find(x) != Q.end()) Q.erase(Q.find(x)), stdQ.erase(x);
+	}
+	const sjtu::map<int, int> cQ(Q);
+	int k = 0;
+	for (auto &p : stdQ) {
+		if (cQ.select(k)->first != p.first || cQ.rank(p.first) != k) return 0;
+		if (Q.select(k)->first != p.first) return 0;
+		k++;
+	}
+	return k == Q.size() && cQ.rank(10000) == k;
+}
+
+bool check3() { // advance and distance
+	sjtu::map<int, int> Q;
+	for (int i = 0; i < 10000; i++) Q[i * 3] = i;
+	const sjtu::map<int, int> &cQ = Q;
+	for (int i = 1; i <= 10000; i++) {
+		int a = Rand() % 10001, b = Rand() % 10001;
+		auto x = Q.select(a), y = Q.advance(x, b - a);
+		if (y != Q.select(b) || Q.distance(x, y) != b - a) return 0;
+		if (cQ.advance(cQ.select(a), b - a) != y || cQ.distance(y, x) != a - b) return 0;
+	}
+	return 1;
+}
+
+bool check4() { // out of range
+	sjtu::map<int, int> Q, P;
+	if (Q.select(0) != Q.end() || Q.rank(0) != 0) return 0;
+	for (int i = 0; i < 100; i++) Q[i] = i;
+	int n = 0;
+	try {Q.select(101);} catch (sjtu::index_out_of_bound) {n++;}
+	try {Q.select(-1);} catch (sjtu::index_out_of_bound) {n++;}
+	try {Q.advance(Q.begin(), -1);} catch (sjtu::invalid_iterator) {n++;}
+	try {Q.advance(Q.begin(), 101);} catch (sjtu::invalid_iterator) {n++;}
+	try {Q.distance(Q.begin(), P.end());} catch (sjtu::invalid_iterator) {n++;}
+	return n == 5 && Q.advance(Q.begin(), 100) == Q.end();
+}
+
+int main() {
+	bool (*check[])() = {check1, check2, check3, check4};
+	for (int i = 0; i < 4; i++) {
+		if (check[i]()) printf("Test %d Passed!\n", i + 1);
+		else printf("Test %d Failed......\n", i + 1);
+	}
+	return 0;
+}
@@ -0,0 +1,227 @@
+#include "map.hpp"
+#include <iostream>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <memory>
+
+int last = 4321;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+class Integer { // a key that is never assigned to
+public:
+	static int counter, built; // alive, and ever made
+	int val;
+	Integer(int val) : val(val) {counter++, built++;}
+	Integer(const Integer &rhs) : val(rhs.val) {counter++, built++;}
+	Integer & operator = (const Integer &rhs) = delete;
+	~Integer() {counter--;}
+	bool operator < (const Integer &rhs) const {return val < rhs.val;}
+};
+
+int Integer::counter = 0, Integer::built = 0;
+
+template <class A, class B>
+bool same(A &Q, const B &stdQ) {
+	if (Q.size() != (int)stdQ.size()) return 0;
+	auto it = Q.cbegin();
+	for (auto &p : stdQ) {
+		if (it == Q.cend() || it->first != p.first || it->second != p.second) return 0;
+		++it;
+	}
+	return it == Q.cend();
+}
+
+bool check1() { // construct from a range, sorted or not
+	typedef sjtu::pair<int, std::string> value;
+	for (int round = 0; round < 20; round++) {
+		std::vector<int> k; // sjtu::pair is not assignable, so the keys are shuffled first
+		std::vector<value> v;
+		std::map<int, std::string> stdQ;
+		int n = round * round * 20;
+		for (int i = 0; i < n; i++) k.push_back(i * 3);
+		if (round % 4 == 1 && n) k.insert(k.begin() + Rand() % n, Rand() % (n * 3)); // out of order from there on
+		if (round % 4 == 2) k.push_back(Rand() % (n * 3 + 1)); // a key met before, or at the end
+		if (round % 4 == 3) std::random_shuffle(k.begin(), k.end(), [](int m) {return Rand() % m;});
+		for (size_t i = 0; i < k.size(); i++) v.push_back(value(k[i], std::to_string(i)));
+		for (auto &p : v) stdQ.insert(std::make_pair(p.first, p.second)); // the first one wins
+		sjtu::map<int, std::string> Q(v.begin(), v.end());
+		if (!same(Q, stdQ)) return 0;
+		for (int i = 0; i < 500; i++) { // still a working tree
+			int x = Rand() % (n * 3 + 10);
+			if (i & 1) Q[x] = "z", stdQ[x] = "z";
+			else if (Q.count(x)) Q.erase(Q.find(x)), stdQ.erase(x);
+		}
+		if (!same(Q, stdQ)) return 0;
+	}
+	{
+		std::vector<sjtu::pair<Integer, int>> v;
+		for (int i = 0; i < 10000; i++) v.push_back(sjtu::pair<Integer, int>(Integer(i / 2), i)); // every key twice
+		sjtu::map<Integer, int> Q(v.begin(), v.end()), R(v.begin(), v.begin());
+		if (Q.size() != 5000 || !R.empty() || Q.at(Integer(1234)) != 2468 || Q.begin()->second != 0) return 0;
+	}
+	return Integer::counter == 0;
+}
+
+struct Pinned {
+	std::string s;
+	Pinned() {}
+	Pinned(int n, char c) : s(n, c) {}
+	Pinned(const Pinned &) = delete;
+	Pinned(Pinned &&) = delete;
+};
+
+bool check2() { // emplace, try_emplace, insert_or_assign and operator[] with an rvalue key
+	{
+		sjtu::map<Integer, std::string> Q;
+		std::map<int, std::string> stdQ;
+		for (int i = 0; i < 20000; i++) {
+			int x = Rand() % 3000, op = Rand() % 4;
+			std::string s = std::to_string(i);
+			if (op == 0) {
+				auto r = Q.emplace(x, s);
+				auto t = stdQ.emplace(x, s);
+				if (r.second != t.second || r.first->second != t.first->second) return 0;
+			}
+			else if (op == 1) {
+				auto r = Q.try_emplace(Integer(x), std::move(s));
+				auto t = stdQ.insert(std::make_pair(x, std::to_string(i)));
+				if (r.second != t.second || r.first->second != t.first->second) return 0;
+				if (!r.second && s != std::to_string(i)) return 0; // not moved from when the key is taken
+			}
+			else if (op == 2) {
+				Integer k(x);
+				auto r = Q.insert_or_assign(k, s);
+				auto t = stdQ.count(x);
+				stdQ[x] = s;
+				if (r.second == (bool)t || r.first->second != s) return 0;
+			}
+			else Q[Integer(x)] += "+", stdQ[x] += "+";
+		}
+		if (Q.size() != (int)stdQ.size()) return 0;
+		auto it = Q.begin();
+		for (auto &p : stdQ) {
+			if (it->first.val != p.first || it->second != p.second) return 0;
+			++it;
+		}
+	}
+	if (Integer::counter != 0) return 0;
+	sjtu::map<std::string, std::unique_ptr<int>> P; // a value that can only be moved
+	std::string k = "a";
+	P[std::move(k)].reset(new int(1));
+	P.emplace("b", std::unique_ptr<int>(new int(2)));
+	std::unique_ptr<int> c(new int(3)), d(new int(4));
+	P.try_emplace("c", std::move(c));
+	P.try_emplace("c", std::move(d));
+	P.insert_or_assign("a", std::unique_ptr<int>(new int(5)));
+	P.insert_or_assign(std::string("d"), std::move(d));
+	if (P.size() != 4 || c || d || *P["a"] != 5 || *P["b"] != 2 || *P["c"] != 3 || *P["d"] != 4) return 0;
+	if (P.emplace("b", std::unique_ptr<int>(new int(6))).second || *P.at("b") != 2) return 0;
+	sjtu::map<int, Pinned> N; // a value that can be neither copied nor moved: it is built in its node
+	N.try_emplace(1, 5, 'x');
+	int j = 2;
+	N.try_emplace(std::move(j), 3, 'y');
+	N[3].s += "z";
+	N[std::move(j)].s += "w";
+	if (!N.try_emplace(4).second || N.try_emplace(1, 9, 'q').second) return 0;
+	return N.size() == 4 && N.at(1).s == "xxxxx" && N.at(2).s == "yyyw" && N.at(3).s == "z" && N.at(4).s.empty();
+}
+
+struct ByVal { // orders Integer and int together, so a lookup by int makes no Integer
+	typedef void is_transparent;
+	bool operator()(const Integer &a, const Integer &b) const {return a.val < b.val;}
+	bool operator()(const Integer &a, int b) const {return a.val < b;}
+	bool operator()(int a, const Integer &b) const {return a < b.val;}
+};
+
+bool check3() { // lookups by a type other than Key through a transparent Compare
+	sjtu::map<std::string, int, std::less<>> Q;
+	std::map<std::string, int, std::less<>> stdQ;
+	std::vector<std::string> names;
+	for (int i = 0; i < 5000; i++) {
+		names.push_back(std::to_string(Rand() % 10000));
+		Q[names.back()] = i, stdQ[names.back()] = i;
+	}
+	const sjtu::map<std::string, int, std::less<>> &C = Q;
+	for (int i = 0; i < 20000; i++) {
+		std::string s = std::to_string(Rand() % 10000);
+		const char *k = s.c_str();
+		if (Q.count(k) != stdQ.count(k) || C.count(k) != stdQ.count(k)) return 0;
+		auto f = stdQ.find(k);
+		if (f == stdQ.end()) {
+			if (Q.find(k) != Q.end() || C.find(k) != C.cend()) return 0;
+			try {Q.at(k); return 0;} catch (sjtu::index_out_of_bound) {}
+			try {C.at(k); return 0;} catch (sjtu::index_out_of_bound) {}
+		}
+		else if (Q.find(k)->second != f->second || C.find(k)->second != f->second || Q.at(k) != f->second || C.at(k) != f->second) return 0;
+		auto l = stdQ.lower_bound(k), u = stdQ.upper_bound(k);
+		auto a = Q.lower_bound(k), b = Q.upper_bound(k);
+		auto c = C.lower_bound(k), d = C.upper_bound(k);
+		if ((l == stdQ.end()) != (a == Q.end()) || (l == stdQ.end()) != (c == C.cend())) return 0;
+		if ((u == stdQ.end()) != (b == Q.end()) || (u == stdQ.end()) != (d == C.cend())) return 0;
+		if (l != stdQ.end() && (a->first != l->first || c->first != l->first)) return 0;
+		if (u != stdQ.end() && (b->first != u->first || d->first != u->first)) return 0;
+		auto r = Q.equal_range(k);
+		auto t = C.equal_range(k);
+		if (r.first != a || r.second != b || t.first != c || t.second != d) return 0;
+	}
+	if (!same(Q, stdQ)) return 0;
+	sjtu::map<Integer, int, ByVal> R;
+	for (int i = 0; i < 1000; i++) R[Integer(i * 2)] = i;
+	int made = Integer::built;
+	for (int i = 0; i < 2000; i++) {
+		if (R.count(i) != !(i & 1)) return 0;
+		if (i & 1 ? R.find(i) != R.end() : R.find(i)->second != i / 2) return 0;
+		if (i < 1998 && (R.lower_bound(i)->first.val != i + (i & 1) || R.upper_bound(i)->first.val != i + 2 - (i & 1))) return 0;
+	}
+	if (R.lower_bound(1999) != R.end() || R.upper_bound(1998) != R.end() || R.equal_range(-1).second->first.val != 0) return 0;
+	return Integer::built == made && R.at(10) == 5;
+}
+
+bool check4() { // insert with a hint that is right, wrong, or of another map
+	typedef sjtu::pair<const int, std::string> value;
+	sjtu::map<int, std::string> Q, P;
+	std::map<int, std::string> stdQ;
+	auto it = Q.end();
+	for (int i = 0; i < 20000; i++) it = Q.insert(Q.end(), value(i * 4, "a")), stdQ[i * 4] = "a"; // ascending at end()
+	if (it->first != 79996 || !same(Q, stdQ)) return 0;
+	for (int i = 19999; i >= 0; i--) { // descending, each before the last one put
+		it = Q.insert(it, value(i * 4 - 2, "b"));
+		stdQ[i * 4 - 2] = "b";
+	}
+	if (it != Q.begin() || !same(Q, stdQ)) return 0;
+	for (int i = 0; i < 50000; i++) {
+		int x = Rand() % 100000 - 10;
+		auto h = Q.upper_bound(x); // the right hint
+		if (Rand() % 2) { // or a wrong one: anywhere, a key present, or the ends
+			int y = Rand() % 100000;
+			h = Rand() % 3 ? Q.lower_bound(y) : (y & 1 ? Q.begin() : Q.end());
+		}
+		std::string s = std::to_string(i);
+		auto r = Q.insert(h, value(x, s));
+		auto t = stdQ.insert(std::make_pair(x, s)); // a key present keeps its value
+		if (r->first != x || r->second != t.first->second) return 0;
+		if (Rand() % 4 == 0) Q.erase(r), stdQ.erase(x);
+	}
+	if (!same(Q, stdQ)) return 0;
+	P[1] = "p";
+	try {Q.insert(P.begin(), value(3, "x")); return 0;} catch (sjtu::invalid_iterator) {}
+	try {Q.insert(P.end(), value(3, "x")); return 0;} catch (sjtu::invalid_iterator) {}
+	value v(-100, "m");
+	it = Q.insert(Q.begin(), std::move(v)); // the rvalue overload
+	return it == Q.begin() && it->second == "m" && Q.size() == (int)stdQ.size() + 1 && P.size() == 1;
+}
+
+int main() {
+	bool (*check[])() = {check1, check2, check3, check4};
+	for (int i = 0; i < 4; i++) {
+		if (check[i]()) printf("Test %d Passed!\n", i + 1);
+		else printf("Test %d Failed......\n", i + 1);
+	}
+	return 0;
+}
@@ -0,0 +1,181 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <cstdio>
+#include <list>
+#include <map>
+#include <string>
+#include <cstdlib>
+#include <new>
+
+int last = 7531;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+/**
+ * the reference: a list in order, and a map from the keys into it.
+ */
+struct Ref {
+	bool access; size_t cap;
+	std::list<std::pair<int, std::string>> l;
+	std::map<int, std::list<std::pair<int, std::string>>::iterator> h;
+	std::string *find(int k) {
+		auto f = h.find(k);
+		if (f == h.end()) return NULL;
+		if (access) l.splice(l.end(), l, f->second);
+		return &f->second->second;
+	}
+	std::string &get(int k) {
+		std::string *p = find(k);
+		if (p) return *p;
+		l.push_back(std::make_pair(k, std::string()));
+		h[k] = --l.end();
+		if (cap && l.size() > cap) h.erase(l.front().first), l.pop_front();
+		return l.back().second;
+	}
+	size_t erase(int k) {
+		auto f = h.find(k);
+		if (f == h.end()) return 0;
+		l.erase(f->second), h.erase(f);
+		return 1;
+	}
+};
+
+typedef sjtu::linked_hashmap<int, std::string> Map;
+
+bool same(const Map &Q, const Ref &R) { // in the same order, both ways
+	if (Q.size() != (int)R.l.size()) return 0;
+	auto it = Q.cbegin();
+	for (auto &p : R.l) {
+		if (it == Q.cend() || it->first != p.first || it->second != p.second) return 0;
+		++it;
+	}
+	if (it != Q.cend()) return 0;
+	for (auto p = R.l.rbegin(); p != R.l.rend(); ++p)
+		if ((--it)->first != p->first) return 0;
+	return 1;
+}
+
+bool workload(bool access, size_t cap) {
+	Map Q(access, cap);
+	Ref R{access, cap, {}, {}};
+	Q.reserve(cap ? cap : 3000);
+	for (int i = 0; i < 100000; i++) {
+		int x = Rand() % 3000, op = Rand() % 8;
+		if (op < 3) {
+			std::string v = std::to_string(i);
+			Q[x] = v, R.get(x) = v;
+		}
+		else if (op == 3) {
+			bool had = R.find(x);
+			auto r = Q.insert(sjtu::pair<const int, std::string>(x, "i"));
+			if (!had) R.get(x) = "i";
+			if (r.second == had || r.first->first != x) return 0;
+		}
+		else if (op == 4) {
+			auto it = Q.find(x);
+			std::string *p = R.find(x);
+			if ((it == Q.end()) != !p || (p && it->second != *p)) return 0;
+			if (p && Rand() % 2) Q.erase(it), R.erase(x);
+			else if (Q.erase(x + 1) != R.erase(x + 1)) return 0;
+		}
+		else if (op == 5) {
+			if (Q.size()) {
+				Q.pop_front();
+				R.h.erase(R.l.front().first), R.l.pop_front();
+			}
+		}
+		else if (op == 6) {
+			auto it = Q.find(x);
+			if (R.find(x)) Q.move_to_back(it), R.l.splice(R.l.end(), R.l, R.h[x]);
+		}
+		else { // const lookups never reorder
+			const Map &C = Q;
+			if (C.count(x) != R.h.count(x)) return 0;
+			if (R.h.count(x) && C.at(x) != R.h[x]->second) return 0;
+			if (Q.size() && (Q.front().first != R.l.front().first || Q.back().first != R.l.back().first)) return 0;
+		}
+		if (cap && Q.size() > (int)cap) return 0;
+		if (i % 10000 == 0) {
+			if (!same(Q, R)) return 0;
+			Map C(Q);
+			C.reserve(5000);
+			if (!same(C, R)) return 0;
+			C = Q;
+			if (!same(C, R)) return 0;
+		}
+	}
+	return same(Q, R);
+}
+
+bool check1() { // insertion order, unbounded and bounded
+	return workload(false, 0) && workload(false, 500);
+}
+
+bool check2() { // access order, unbounded and as an lru cache
+	return workload(true, 0) && workload(true, 500);
+}
+
+bool check3() { // an lru cache of 3 by hand
+	Map Q(true, 3);
+	Q[1] = "a", Q[2] = "b", Q[3] = "c";
+	Q.find(1); // 2 3 1
+	Q[4] = "d"; // 2 is dropped: 3 1 4
+	if (Q.count(2) || Q.size() != 3 || Q.front().first != 3 || Q.back().first != 4) return 0;
+	Q.at(3); // 1 4 3
+	Q.insert(sjtu::pair<const int, std::string>(1, "x")); // 4 3 1, and 1 keeps "a"
+	Q[5] = "e"; // 3 1 5
+	std::string s;
+	for (auto it = Q.cbegin(); it != Q.cend(); ++it) s += std::to_string(it->first) + it->second;
+	if (s != "3c1a5e") return 0;
+	Q.move_to_back(Q.find(3)), Q.pop_front(); // 5 3
+	if (Q.size() != 2 || Q.front().second != "e" || Q.back().second != "c") return 0;
+	Q.pop_front(), Q.pop_front();
+	try {Q.pop_front(); return 0;} catch (sjtu::container_is_empty) {}
+	try {Q.front(); return 0;} catch (sjtu::container_is_empty) {}
+	try {Q.erase(Q.end()); return 0;} catch (sjtu::invalid_iterator) {}
+	try {Q.at(1); return 0;} catch (sjtu::index_out_of_bound) {}
+	Map I; // insertion order: lookups leave it be
+	I[1] = "a", I[2] = "b";
+	I.find(1), I[1] = "c";
+	return I.front().second == "c" && I.back().first == 2;
+}
+
+int allocs; // the calls to operator new, to see that reserve keeps its promise
+
+void *operator new(size_t n) {
+	allocs++;
+	if (void *p = malloc(n ? n : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {free(p);}
+void operator delete(void *p, size_t) noexcept {free(p);}
+
+bool check4() { // after reserve(n), inserting up to n elements allocates nothing
+	sjtu::linked_hashmap<int, int> Q;
+	Q[1] = 1;
+	Q.reserve(100); // the nodes left in the first slab count as well
+	int n = allocs;
+	for (int i = 2; i <= 100; i++) Q[i] = i;
+	if (allocs != n || Q.size() != 100) return 0;
+	for (int i = 1; i <= 60; i++) Q.erase(i);
+	Q.reserve(300); // the 60 freed nodes as well
+	n = allocs;
+	for (int i = 101; i <= 360; i++) Q[i] = i;
+	if (allocs != n || Q.size() != 300) return 0;
+	sjtu::linked_hashmap<int, int> R;
+	R[-1] = 0;
+	R = Q; // the freed node of R is used too
+	return R.size() == 300 && R.front().first == 61 && R.back().first == 360;
+}
+
+int main() {
+	bool (*check[])() = {check1, check2, check3, check4};
+	for (int i = 0; i < 4; i++) {
+		if (check[i]()) printf("Test %d Passed!\n", i + 1);
+		else printf("Test %d Failed......\n", i + 1);
+	}
+	return 0;
+}
@@ -0,0 +1,149 @@
+#include "unordered_map.hpp"
+#include <iostream>
+#include <cstdio>
+#include <map>
+#include <string>
+
+int last = 8642;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+template <class A, class B>
+bool same(const A &Q, const B &stdQ) { // the same elements, in any order
+	if (Q.size() != (int)stdQ.size()) return 0;
+	int n = 0;
+	for (auto it = Q.cbegin(); it != Q.cend(); ++it, ++n) {
+		auto p = stdQ.find(it->first);
+		if (p == stdQ.end() || p->second != it->second) return 0;
+	}
+	if (n != Q.size()) return 0;
+	for (auto &p : stdQ)
+		if (!Q.count(p.first) || Q.at(p.first) != p.second) return 0;
+	return 1;
+}
+
+struct few { // every key in one of 4 probe sequences
+	size_t operator()(int x) const {return x & 3;}
+};
+
+bool check1() { // churn at a steady size: erased slots pile up and are rehashed away
+	sjtu::unordered_map<int, std::string> Q;
+	std::map<int, std::string> stdQ;
+	for (int round = 0; round < 20; round++) { // fill to the brim, erase most, and refill
+		for (int i = 0; Q.size() < 3584; i++) Q[round * 10000 + i] = "f", stdQ[round * 10000 + i] = "f";
+		while (Q.size() > 1500) {
+			int x = stdQ.begin()->first + Rand() % 5;
+			if (Q.erase(x) != stdQ.erase(x)) return 0;
+		}
+		if (!same(Q, stdQ)) return 0;
+	}
+	Q.clear(), stdQ.clear();
+	for (int round = 0; round < 5; round++) {
+		for (int i = 1; i <= 200000; i++) {
+			int x = Rand() % (round & 1 ? 3000 : 300000);
+			if (Q.size() < 2000 || Rand() % 2) Q[x] = std::to_string(i), stdQ[x] = std::to_string(i);
+			else {
+				auto it = Q.find(stdQ.begin()->first);
+				stdQ.erase(stdQ.begin());
+				Q.erase(it);
+				if (Q.erase(x) != stdQ.erase(x)) return 0;
+			}
+			if (i % 40000 == 0 && !same(Q, stdQ)) return 0;
+		}
+		while (Q.size() > 100) {
+			int x = stdQ.begin()->first;
+			stdQ.erase(stdQ.begin());
+			if (Q.erase(x) != 1) return 0;
+		}
+		if (!same(Q, stdQ)) return 0;
+	}
+	return 1;
+}
+
+bool check2() { // long collision chains, across the end of the table
+	sjtu::unordered_map<int, int, few> Q;
+	std::map<int, int> stdQ;
+	for (int i = 0; i < 3000; i++) {
+		int x = Rand() % 5000;
+		Q[x] = i, stdQ[x] = i;
+		if (i % 3 == 0) {
+			int y = Rand() % 5000;
+			if (Q.erase(y) != stdQ.erase(y)) return 0;
+		}
+	}
+	if (!same(Q, stdQ)) return 0;
+	for (int n = 1; n < 40; n++) { // small tables, where a group wraps around
+		sjtu::unordered_map<int, int, few> R;
+		std::map<int, int> stdR;
+		for (int i = 0; i < 200; i++) {
+			int x = Rand() % (n + 3);
+			if (Rand() % 3) R[x] = i, stdR[x] = i;
+			else if (R.erase(x) != stdR.erase(x)) return 0;
+		}
+		if (!same(R, stdR)) return 0;
+	}
+	return 1;
+}
+
+bool check3() { // reserve, copy and assignment
+	sjtu::unordered_map<int, std::string> Q(10);
+	std::map<int, std::string> stdQ;
+	Q.reserve(50000);
+	for (int i = 0; i < 50000; i++) {
+		int x = Rand();
+		Q[x] = std::to_string(x), stdQ[x] = std::to_string(x);
+	}
+	Q.reserve(10);
+	sjtu::unordered_map<int, std::string> R(Q), S, E;
+	S = Q;
+	std::map<int, std::string> stdR(stdQ);
+	for (int i = 0; i < 10000; i++) {
+		int x = Rand();
+		if (R.erase(x) != stdR.erase(x)) return 0;
+		Q[x] = "q";
+	}
+	if (!same(R, stdR) || !same(S, stdQ)) return 0;
+	S = E;
+	S[1] = "1";
+	if (S.size() != 1 || S.at(1) != "1" || E.size() || E.begin() != E.end()) return 0;
+	try {E.at(1); return 0;} catch (sjtu::index_out_of_bound) {}
+	try {E.erase(E.end()); return 0;} catch (sjtu::invalid_iterator) {}
+	try {E.erase(S.begin()); return 0;} catch (sjtu::invalid_iterator) {}
+	return 1;
+}
+
+bool check4() { // erase while iterating: only the erased iterator is invalidated
+	sjtu::unordered_map<int, int> Q;
+	std::map<int, int> stdQ;
+	for (int i = 0; i < 100000; i++) {
+		int x = Rand() % 200000;
+		Q[x] = i, stdQ[x] = i;
+	}
+	for (int m = 2; m <= 5; m++) {
+		for (auto it = Q.begin(); it != Q.end(); ) {
+			auto nx = it;
+			++nx;
+			if (it->first % m == 0) stdQ.erase(it->first), Q.erase(it);
+			it = nx;
+		}
+		if (!same(Q, stdQ)) return 0;
+	}
+	for (auto it = Q.begin(); it != Q.end(); ) {
+		auto nx = it;
+		++nx;
+		Q.erase(it);
+		it = nx;
+	}
+	return Q.empty() && Q.begin() == Q.end();
+}
+
+int main() {
+	bool (*check[])() = {check1, check2, check3, check4};
+	for (int i = 0; i < 4; i++) {
+		if (check[i]()) printf("Test %d Passed!\n", i + 1);
+		else printf("Test %d Failed......\n", i + 1);
+	}
+	return 0;
+}
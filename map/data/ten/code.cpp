@@ -0,0 +1,112 @@
+#include "map.hpp"
+#include <iostream>
+#include <cstdio>
+#include <map>
+#include <string>
+
+int last = 23333;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+template <class A, class B>
+bool same(const A &Q, const B &stdQ) {
+	if (Q.size() != (int)stdQ.size()) return 0;
+	auto it = Q.cbegin();
+	for (auto &p : stdQ) {
+		if (it == Q.cend() || it->first != p.first || it->second != p.second) return 0;
+		++it;
+	}
+	return it == Q.cend();
+}
+
+bool check1() { // split at random keys and join back
+	sjtu::map<int, std::string> Q;
+	std::map<int, std::string> stdQ;
+	for (int i = 1; i <= 20000; i++) {
+		int x = Rand() % 50000;
+		Q[x] = std::to_string(i); stdQ[x] = std::to_string(i);
+	}
+	for (int i = 1; i <= 200; i++) {
+		int x = Rand() % 50002 - 1;
+		sjtu::map<int, std::string> R = Q.split(x);
+		std::map<int, std::string> stdR(stdQ.lower_bound(x), stdQ.end()), stdL(stdQ.begin(), stdQ.lower_bound(x));
+		if (!same(Q, stdL) || !same(R, stdR)) return 0;
+		if (i & 1) Q.join(std::move(R));
+		else R.join(std::move(Q)), Q.join(std::move(R));
+		if (R.size() || !same(Q, stdQ)) return 0;
+	}
+	return 1;
+}
+
+bool check2() { // the parts live on their own
+	sjtu::map<int, std::string> *Q = new sjtu::map<int, std::string>;
+	std::map<int, std::string> stdQ;
+	for (int i = 0; i < 10000; i++) (*Q)[i] = std::to_string(i), stdQ[i] = std::to_string(i);
+	sjtu::map<int, std::string> R = Q->split(3000), S = R.split(6000);
+	delete Q;
+	for (int i = 0; i < 3000; i++) {
+		int x = Rand() % 3000 + 3000;
+		R.erase(R.find(x)), R[x] = "r";
+		S[x + 7000] = "s";
+		stdQ[x] = "r";
+		stdQ[x + 7000] = "s";
+	}
+	stdQ.erase(stdQ.begin(), stdQ.lower_bound(3000));
+	R.join(std::move(S));
+	return same(R, stdQ) && R.select(R.size() - 1)->first == stdQ.rbegin()->first;
+}
+
+bool check3() { // join needs the key ranges apart
+	sjtu::map<int, int> Q, R;
+	for (int i = 0; i < 100; i++) Q[i * 2] = i, R[i + 150] = i;
+	try {Q.join(std::move(R)); return 0;} catch (sjtu::runtime_error) {}
+	try {R.join(std::move(Q)); return 0;} catch (sjtu::runtime_error) {}
+	if (Q.size() != 100 || R.size() != 100) return 0;
+	sjtu::map<int, int> S = R.split(199);
+	Q.join(std::move(S));
+	return Q.size() == 151 && S.empty() && R.size() == 49 && Q.split(1000).empty() && Q.split(-1).size() == 151;
+}
+
+int copies;
+
+struct Counted { // a value that counts its copies
+	int v;
+	Counted(int v = 0) : v(v) {}
+	Counted(const Counted &b) : v(b.v) {copies++;}
+	Counted &operator=(const Counted &b) {v = b.v, copies++; return *this;}
+};
+
+bool check4() { // a split map is moved into place, not copied
+	sjtu::map<int, Counted> Q, R;
+	std::map<int, int> stdQ;
+	for (int i = 0; i < 10000; i++) Q[i * 3] = Counted(i), stdQ[i * 3] = i;
+	R[-5] = Counted(7);
+	copies = 0;
+	R = Q.split(15000); // assignment from a temporary: R loses its element and takes the split
+	sjtu::map<int, Counted> S(std::move(R)), T;
+	T = std::move(S);
+	T = std::move(T);
+	sjtu::map<int, Counted> &U = T;
+	T = std::move(U);
+	if (copies != 0 || !R.empty() || !S.empty() || T.size() != 5000 || Q.size() != 5000) return 0;
+	if (T.begin()->first != 15000 || T.at(29997).v != 9999 || Q.count(15000)) return 0;
+	R[1] = Counted(1), S[2] = Counted(2); // the moved-from maps still work
+	Q.join(std::move(T));
+	auto it = Q.cbegin();
+	for (auto &p : stdQ) {
+		if (it == Q.cend() || it->first != p.first || it->second.v != p.second) return 0;
+		++it;
+	}
+	return R.size() == 1 && S.size() == 1 && Q.select(7500)->first == 22500;
+}
+
+int main() {
+	bool (*check[])() = {check1, check2, check3, check4};
+	for (int i = 0; i < 4; i++) {
+		if (check[i]()) printf("Test %d Passed!\n", i + 1);
+		else printf("Test %d Failed......\n", i + 1);
+	}
+	return 0;
+}
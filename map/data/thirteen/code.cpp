@@ -0,0 +1,138 @@
+#include "map.hpp"
+#include <iostream>
+#include <cstdio>
+#include <map>
+#include <string>
+
+int last = 9876;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+template <class A, class B>
+bool same(A &Q, const B &stdQ) { // also rank and select, as erase patches the subtree sizes
+	if (Q.size() != (int)stdQ.size()) return 0;
+	auto it = Q.cbegin();
+	int i = 0;
+	for (auto &p : stdQ) {
+		if (it == Q.cend() || it->first != p.first || it->second != p.second) return 0;
+		if (i % 13 == 0 && (Q.rank(p.first) != i || Q.select(i)->first != p.first)) return 0;
+		++it, ++i;
+	}
+	if (Q.size() && (Q.select(Q.size() - 1)->first != stdQ.rbegin()->first || Q.rank(stdQ.rbegin()->first + 1) != Q.size())) return 0;
+	return it == Q.cend();
+}
+
+bool check1() { // erase by key and by iterator
+	sjtu::map<int, std::string> Q;
+	std::map<int, std::string> stdQ;
+	for (int i = 1; i <= 20000; i++) {
+		int x = Rand() % 30000;
+		Q[x] = std::to_string(i), stdQ[x] = std::to_string(i);
+	}
+	for (int i = 1; i <= 20000; i++) {
+		int x = Rand() % 30000;
+		if (i & 1) {
+			if (Q.erase(x) != stdQ.erase(x)) return 0;
+		}
+		else {
+			auto it = Q.lower_bound(x);
+			if (it != Q.end()) stdQ.erase(it->first), Q.erase(it);
+		}
+		if (i % 1000 == 0 && !same(Q, stdQ)) return 0;
+		if (i % 3 == 0) Q[x + 1] = "a", stdQ[x + 1] = "a";
+	}
+	while (Q.size()) {
+		if (Q.erase(Q.begin()->first) != 1) return 0;
+		stdQ.erase(stdQ.begin());
+		if (Q.size() % 997 == 0 && !same(Q, stdQ)) return 0;
+	}
+	return Q.erase(5) == 0 && Q.empty();
+}
+
+bool check2() { // range erase at both ends, in the middle, and empty ranges
+	sjtu::map<int, std::string> Q;
+	std::map<int, std::string> stdQ;
+	for (int i = 0; i < 5000; i++) Q[i * 3] = std::to_string(i), stdQ[i * 3] = std::to_string(i);
+	auto e = Q.erase(Q.begin(), Q.lower_bound(300));
+	stdQ.erase(stdQ.begin(), stdQ.lower_bound(300));
+	if (e != Q.begin() || e->first != 300 || !same(Q, stdQ)) return 0;
+	e = Q.erase(Q.lower_bound(14000), Q.end());
+	stdQ.erase(stdQ.lower_bound(14000), stdQ.end());
+	if (e != Q.end() || !same(Q, stdQ)) return 0;
+	for (int i = 0; i < 500; i++) {
+		int x = Rand() % 15000, y = x + Rand() % 100;
+		auto a = Q.lower_bound(x);
+		if (Q.erase(a, a) != a) return 0;
+		e = Q.erase(Q.lower_bound(x), Q.lower_bound(y));
+		stdQ.erase(stdQ.lower_bound(x), stdQ.lower_bound(y));
+		if (e != Q.lower_bound(y)) return 0;
+		if (i % 50 == 0 && !same(Q, stdQ)) return 0;
+		Q[y + 1] = "b", stdQ[y + 1] = "b";
+	}
+	if (Q.erase(Q.end(), Q.end()) != Q.end() || !same(Q, stdQ)) return 0;
+	Q.erase(Q.begin(), Q.end());
+	return Q.empty() && same(Q, std::map<int, std::string>()) && Q.begin() == Q.end();
+}
+
+bool check3() { // invalid_iterator for reversed and foreign iterators
+	sjtu::map<int, int> Q, R;
+	for (int i = 0; i < 100; i++) Q[i] = i, R[i] = i;
+	try {Q.erase(Q.find(50), Q.find(10)); return 0;} catch (sjtu::invalid_iterator) {}
+	try {Q.erase(Q.end(), Q.begin()); return 0;} catch (sjtu::invalid_iterator) {}
+	try {Q.erase(R.find(10), Q.find(50)); return 0;} catch (sjtu::invalid_iterator) {}
+	try {Q.erase(Q.find(10), R.find(50)); return 0;} catch (sjtu::invalid_iterator) {}
+	try {Q.erase(R.begin()); return 0;} catch (sjtu::invalid_iterator) {}
+	try {Q.erase(Q.end()); return 0;} catch (sjtu::invalid_iterator) {}
+	std::map<int, int> stdQ;
+	for (int i = 0; i < 100; i++) stdQ[i] = i;
+	return same(Q, stdQ) && same(R, stdQ);
+}
+
+bool check4() { // erase_if
+	sjtu::map<int, std::string> Q;
+	std::map<int, std::string> stdQ;
+	for (int i = 1; i <= 20000; i++) {
+		int x = Rand() % 50000;
+		Q[x] = std::to_string(i), stdQ[x] = std::to_string(i);
+	}
+	for (int m = 2; m <= 7; m++) {
+		size_t n = Q.erase_if([m](sjtu::pair<const int, std::string> &p) {return p.first % m == 1;}), c = 0;
+		for (auto it = stdQ.begin(); it != stdQ.end(); )
+			if (it->first % m == 1) it = stdQ.erase(it), c++;
+			else ++it;
+		if (n != c || !same(Q, stdQ)) return 0;
+		for (int i = 0; i < 1000; i++) {
+			int x = Rand() % 50000;
+			Q[x] = "c", stdQ[x] = "c";
+		}
+	}
+	if (Q.erase_if([](sjtu::pair<const int, std::string> &) {return false;}) != 0 || !same(Q, stdQ)) return 0;
+	int stop = stdQ.rbegin()->first / 2;
+	try { // a throw halfway keeps what is erased erased, and the tree whole
+		Q.erase_if([stop](sjtu::pair<const int, std::string> &p) {
+			if (p.first >= stop) throw sjtu::runtime_error();
+			return p.first % 2 == 0;
+		});
+		return 0;
+	} catch (sjtu::runtime_error) {}
+	for (auto it = stdQ.begin(); it != stdQ.end() && it->first < stop; )
+		if (it->first % 2 == 0) it = stdQ.erase(it);
+		else ++it;
+	for (int i = 0; i < 5000; i++) {
+		int x = Rand() % 50000;
+		if (Q.count(x) != stdQ.count(x)) return 0;
+	}
+	if (!same(Q, stdQ)) return 0;
+	return Q.erase_if([](sjtu::pair<const int, std::string> &) {return true;}) == stdQ.size() && Q.empty();
+}
+
+int main() {
+	bool (*check[])() = {check1, check2, check3, check4};
+	for (int i = 0; i < 4; i++) {
+		if (check[i]()) printf("Test %d Passed!\n", i + 1);
+		else printf("Test %d Failed......\n", i + 1);
+	}
+	return 0;
+}
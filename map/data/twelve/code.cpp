@@ -0,0 +1,174 @@
+#include "map.hpp"
+#include <iostream>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <cstdlib>
+#include <new>
+
+int last = 4321;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+template <class A, class B>
+bool same(const A &Q, const B &stdQ) {
+	if (Q.size() != (int)stdQ.size()) return 0;
+	auto it = Q.cbegin();
+	int i = 0;
+	for (auto &p : stdQ) {
+		if (it == Q.cend() || it->first != p.first || it->second != p.second) return 0;
+		if (i % 37 == 0 && (Q.rank(p.first) != i || Q.select(i)->first != p.first)) return 0;
+		++it, ++i;
+	}
+	return it == Q.cend();
+}
+
+void churn(sjtu::map<int, std::string> &Q, std::map<int, std::string> &stdQ, int n) {
+	for (int i = 0; i < n; i++) {
+		int x = Rand() % 20000;
+		if (Rand() % 3) Q[x] = std::to_string(i), stdQ[x] = std::to_string(i);
+		else if (Q.erase(x) != stdQ.erase(x)) throw 0;
+	}
+}
+
+bool check1() { // a full pass after churn
+	sjtu::map<int, std::string> Q;
+	std::map<int, std::string> stdQ;
+	if (!Q.defragment(5)) return 0;
+	Q.defragment();
+	for (int round = 0; round < 5; round++) {
+		churn(Q, stdQ, 30000);
+		Q.defragment();
+		if (!same(Q, stdQ)) return 0;
+	}
+	churn(Q, stdQ, 1000);
+	return same(Q, stdQ);
+}
+
+bool check2() { // incremental passes with inserts and erases in between
+	sjtu::map<int, std::string> Q;
+	std::map<int, std::string> stdQ;
+	churn(Q, stdQ, 20000);
+	for (int round = 0; round < 30; round++) {
+		int passes = 0;
+		while (!Q.defragment(Rand() % 300)) {
+			passes++;
+			for (int i = 0; i < 20; i++) {
+				int x = Rand() % 20000;
+				if (i % 4 == 0) Q[x] = "i", stdQ[x] = "i";
+				else if (i % 4 == 1) {if (Q.erase(x) != stdQ.erase(x)) return 0;}
+				else if (i % 4 == 2) {
+					auto it = Q.lower_bound(x);
+					if (it != Q.end()) stdQ.erase(it->first), Q.erase(it); // often the node the pass moves next
+				}
+				else {
+					int y = x + Rand() % 50;
+					Q.erase(Q.lower_bound(x), Q.lower_bound(y));
+					stdQ.erase(stdQ.lower_bound(x), stdQ.lower_bound(y));
+				}
+			}
+			if (passes % 10 == 0 && !same(Q, stdQ)) return 0;
+		}
+		if (!same(Q, stdQ)) return 0;
+		churn(Q, stdQ, 500);
+	}
+	return 1;
+}
+
+bool check3() { // split, join and merge in the middle of a pass
+	sjtu::map<int, std::string> Q, R;
+	std::map<int, std::string> stdQ, stdR;
+	churn(Q, stdQ, 20000);
+	for (int round = 0; round < 40; round++) {
+		Q.defragment(Rand() % 2000);
+		int x = Rand() % 20000;
+		sjtu::map<int, std::string> S = Q.split(x);
+		std::map<int, std::string> stdS(stdQ.lower_bound(x), stdQ.end());
+		stdQ.erase(stdQ.lower_bound(x), stdQ.end());
+		S.defragment(Rand() % 500);
+		if (!same(Q, stdQ) || !same(S, stdS)) return 0;
+		S[x] = "s", stdS[x] = "s";
+		Q.join(std::move(S));
+		stdQ.insert(stdS.begin(), stdS.end());
+		if (!same(Q, stdQ)) return 0;
+		for (int i = 0; i < 100; i++) {
+			int y = Rand() % 30000;
+			R[y] = "r", stdR[y] = "r";
+		}
+		R.defragment(Rand() % 50);
+		Q.defragment(Rand() % 50);
+		Q.merge(std::move(R));
+		for (auto it = stdR.begin(); it != stdR.end(); )
+			if (stdQ.insert(*it).second) it = stdR.erase(it);
+			else ++it;
+		if (!same(Q, stdQ) || !same(R, stdR)) return 0;
+		Q.defragment(Rand() % 50);
+		churn(Q, stdQ, 200);
+	}
+	Q.defragment();
+	return same(Q, stdQ);
+}
+
+bool check4() { // copies, assignment and clear during a pass
+	sjtu::map<int, std::string> Q;
+	std::map<int, std::string> stdQ;
+	churn(Q, stdQ, 20000);
+	Q.defragment(1000);
+	sjtu::map<int, std::string> C(Q);
+	C.defragment(77);
+	if (!same(C, stdQ)) return 0;
+	Q.defragment(1000);
+	C.defragment(100);
+	C = Q;
+	C.defragment(3);
+	std::map<int, std::string> stdC = stdQ;
+	Q.clear();
+	stdQ.clear();
+	if (!Q.defragment(3) || !same(Q, stdQ)) return 0;
+	churn(Q, stdQ, 5000);
+	Q.defragment(100);
+	C.defragment();
+	return same(Q, stdQ) && same(C, stdC);
+}
+
+int allocs; // the calls to operator new
+
+void *operator new(size_t n) {
+	allocs++;
+	if (void *p = malloc(n ? n : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {free(p);}
+void operator delete(void *p, size_t) noexcept {free(p);}
+
+bool check5() { // assignment reuses the nodes it frees before it asks for a slab
+	sjtu::map<int, int> Q, R;
+	for (int i = 0; i < 3000; i++) Q[i] = i, R[-i] = i;
+	int n = allocs;
+	R = Q; // 3000 nodes freed, 3000 needed
+	if (allocs != n) return 0;
+	sjtu::map<int, int> S;
+	S[7] = 7; // the first slab has 7 nodes left
+	n = allocs;
+	S = Q; // those, and one slab for the rest
+	if (allocs != n + 2) return 0; // the slab and its record
+	for (int i = 0; i < 1000; i++) S.erase(i * 3);
+	n = allocs;
+	for (int i = 0; i < 1000; i++) S[-i - 1] = i;
+	if (allocs != n) return 0;
+	int k = 0;
+	for (auto &p : R) if (p.first != k++ || p.second != p.first) return 0;
+	return k == 3000 && S.size() == 3000 && Q.size() == 3000;
+}
+
+int main() {
+	bool (*check[])() = {check1, check2, check3, check4, check5};
+	for (int i = 0; i < 5; i++) {
+		if (check[i]()) printf("Test %d Passed!\n", i + 1);
+		else printf("Test %d Failed......\n", i + 1);
+	}
+	return 0;
+}
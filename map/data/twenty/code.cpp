@@ -0,0 +1,101 @@
+#include "map.hpp"
+#include <iostream>
+#include <cstdio>
+#include <map>
+#include <string>
+
+int last = 16180;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+long long calls; // the compares made, which show the path a lookup takes
+
+struct CountLess {
+	bool operator()(int a, int b) const {
+		calls++;
+		return a < b;
+	}
+};
+
+typedef sjtu::map<int, std::string, CountLess> Map;
+
+bool same(const Map &Q, const std::map<int, std::string> &stdQ) { // also select, rank and advance
+	if (Q.size() != (int)stdQ.size()) return 0;
+	auto it = Q.cbegin();
+	int i = 0;
+	for (auto &p : stdQ) {
+		if (it == Q.cend() || it->first != p.first || it->second != p.second) return 0;
+		if (i % 7 == 0 && (Q.rank(p.first) != i || Q.select(i)->first != p.first || Q.advance(Q.cbegin(), i) != it)) return 0;
+		++it, ++i;
+	}
+	return it == Q.cend() && Q.distance(Q.cbegin(), Q.cend()) == Q.size();
+}
+
+long long cost(const Map &C, int k) { // the compares of a const find of k
+	long long c = calls;
+	C.find(k);
+	return calls - c;
+}
+
+bool check1() { // const lookups, hits and misses, never change the tree
+	Map Q;
+	std::map<int, std::string> stdQ;
+	for (int i = 0; i < 20000; i++) {
+		int x = Rand() % 100000 * 2; // even keys: the odd ones miss
+		Q[x] = std::to_string(i), stdQ[x] = std::to_string(i);
+	}
+	const Map &C = Q;
+	long long before[200];
+	for (int i = 0; i < 200; i++) before[i] = cost(C, i * 997);
+	for (int i = 0; i < 50000; i++) {
+		int x = Rand() % 200002 - 1;
+		bool in = stdQ.count(x);
+		if (C.count(x) != in || (C.find(x) != C.cend()) != in) return 0;
+		if (in && (C.at(x) != stdQ[x] || C[x] != stdQ[x])) return 0;
+		if (!in) {
+			try {C.at(x); return 0;} catch (sjtu::index_out_of_bound) {}
+			try {C[x]; return 0;} catch (sjtu::index_out_of_bound) {}
+		}
+		auto l = stdQ.lower_bound(x);
+		auto a = C.lower_bound(x), b = C.upper_bound(x);
+		if ((l == stdQ.end()) != (a == C.cend()) || (l != stdQ.end() && a->first != l->first)) return 0;
+		if (in ? b != ++C.find(x) : b != a) return 0;
+		C.rank(x), C.equal_range(x);
+	}
+	// had a lookup splayed, the path to a key would have changed, and its cost with it
+	for (int i = 0; i < 200; i++) if (cost(C, i * 997) != before[i]) return 0;
+	return same(C, stdQ);
+}
+
+bool check2() { // rebalance
+	Map Q;
+	std::map<int, std::string> stdQ;
+	for (int i = 0; i < 100000; i++) Q[i] = "a", stdQ[i] = "a"; // ascending: a path, not a tree
+	Q.find(0); // the deepest key, splayed up: the tree is still deep
+	Q.rebalance();
+	const Map &C = Q;
+	long long worst = 0;
+	for (int i = 0; i < 100000; i += 37) worst = std::max(worst, cost(C, i));
+	if (worst > 2 * 18) return 0; // a compare or two per level, and 17 levels
+	if (!same(C, stdQ)) return 0;
+	for (int i = 0; i < 20000; i++) { // still a working tree
+		int x = Rand() % 120000;
+		if (i & 1) Q[x] = "b", stdQ[x] = "b";
+		else if (Q.count(x)) Q.erase(Q.find(x)), stdQ.erase(x);
+	}
+	Q.rebalance();
+	Map E;
+	E.rebalance();
+	return same(C, stdQ) && E.empty() && E.begin() == E.end();
+}
+
+int main() {
+	bool (*check[])() = {check1, check2};
+	for (int i = 0; i < 2; i++) {
+		if (check[i]()) printf("Test %d Passed!\n", i + 1);
+		else printf("Test %d Failed......\n", i + 1);
+	}
+	return 0;
+}
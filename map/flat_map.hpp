@@ -0,0 +1,324 @@
+/**
+ * a sorted array with the interface of sjtu::map, for maps built once and read often
+ */
+
+#ifndef SJTU_FLAT_MAP_HPP
+#define SJTU_FLAT_MAP_HPP
+
+#include <algorithm>
+#include <functional>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+/**
+ * the keys and the values in two arrays, sorted by key: a lookup is a
+ * binary search over the keys alone, without a branch to mispredict, and
+ * it never writes, so any number of threads may read a map no one writes.
+ * a single insert or erase shifts the elements after it, O(n); to build a
+ * map, insert a whole range at once, which sorts it and merges it in.
+ * the elements are not stored as value_type, so an iterator gives a pair of
+ * references (bind it with auto or auto &&, not auto &). an insert or erase
+ * invalidates every iterator.
+ */
+template<
+	class Key,
+	class T,
+	class Compare = std::less<Key>
+> class flat_map {
+
+public:
+	class const_iterator;
+	class iterator;
+	typedef sjtu::pair<const Key, T> value_type;
+	typedef sjtu::pair<const Key &, T &> reference;
+	typedef sjtu::pair<const Key &, const T &> const_reference;
+
+private:
+	Key *K; T *V;
+	size_t sz, cap;
+
+	static bool less(const Key &a, const Key &b) {return Compare()(a, b);}
+
+	template <class U>
+	static U *alloc(size_t n) {return n ? (U *)operator new(sizeof(U) * n) : NULL;}
+
+	template <class U>
+	static void move(U *from, U *to) { // construct *to from *from and destroy *from
+		new(to) U(std::move(*from));
+		from->~U();
+	}
+
+	/**
+	 * the first i with !(K[i] < k), halving the range with a conditional
+	 * move rather than a branch. the two places the next step may look at
+	 * are fetched ahead, which hides most of the misses on a big map.
+	 */
+	size_t lower(const Key &k) const {
+		if (!sz) return 0;
+		const Key *base = K;
+		size_t n = sz;
+		while (n > 1) {
+			size_t half = n / 2;
+			__builtin_prefetch(base + half / 2);
+			__builtin_prefetch(base + half + half / 2);
+			base = less(base[half], k) ? base + half : base;
+			n -= half;
+		}
+		return base - K + less(*base, k);
+	}
+
+	size_t upper(const Key &k) const { // the first i with k < K[i]
+		if (!sz) return 0;
+		const Key *base = K;
+		size_t n = sz;
+		while (n > 1) {
+			size_t half = n / 2;
+			__builtin_prefetch(base + half / 2);
+			__builtin_prefetch(base + half + half / 2);
+			base = less(k, base[half]) ? base : base + half;
+			n -= half;
+		}
+		return base - K + !less(k, *base);
+	}
+
+	size_t search(const Key &k) const { // the index of k, or sz
+		size_t i = lower(k);
+		return i < sz && !less(k, K[i]) ? i : sz;
+	}
+
+	void grow(size_t n) { // to room for n
+		Key *k = alloc<Key>(n); T *v = alloc<T>(n);
+		for (size_t i = 0; i < sz; i++) move(K + i, k + i), move(V + i, v + i);
+		operator delete(K), operator delete(V);
+		K = k, V = v, cap = n;
+	}
+
+	template <class KK, class VV>
+	size_t put(size_t i, KK &&k, VV &&v) { // a new element at i
+		if (sz == cap) grow(cap ? cap * 2 : 8);
+		for (size_t j = sz; j > i; j--) move(K + j - 1, K + j), move(V + j - 1, V + j);
+		new(K + i) Key(std::forward<KK>(k));
+		new(V + i) T(std::forward<VV>(v));
+		sz++;
+		return i;
+	}
+
+	void del(size_t i) {
+		K[i].~Key(), V[i].~T();
+		for (size_t j = i + 1; j < sz; j++) move(K + j, K + j - 1), move(V + j, V + j - 1);
+		sz--;
+	}
+
+	/**
+	 * [n, sz) were appended out of order: sort them by key, the first of
+	 * equal keys kept, and merge them with [0, n) into new arrays; a key
+	 * already in [0, n) keeps its value.
+	 */
+	void settle(size_t n) {
+		size_t m = sz - n, *p = new size_t[m];
+		for (size_t j = 0; j < m; j++) p[j] = n + j;
+		std::stable_sort(p, p + m, [this](size_t a, size_t b) {return less(K[a], K[b]);});
+		Key *k = alloc<Key>(sz); T *v = alloc<T>(sz);
+		size_t i = 0, j = 0, c = 0;
+		while (i < n || j < m) {
+			size_t x;
+			if (j == m || (i < n && !less(K[p[j]], K[i]))) x = i++;
+			else x = p[j++];
+			// the rest of the range equal to x is dropped
+			while (j < m && !less(K[x], K[p[j]])) K[p[j]].~Key(), V[p[j]].~T(), j++;
+			move(K + x, k + c), move(V + x, v + c);
+			c++;
+		}
+		delete [] p;
+		operator delete(K), operator delete(V);
+		K = k, V = v;
+		cap = sz, sz = c;
+	}
+
+	void free_all() {
+		for (size_t i = 0; i < sz; i++) K[i].~Key(), V[i].~T();
+		operator delete(K), operator delete(V);
+	}
+
+	void copy(const flat_map &other) { // into an empty map
+		grow(other.sz);
+		for (size_t i = 0; i < other.sz; i++) new(K + i) Key(other.K[i]), new(V + i) T(other.V[i]);
+		sz = other.sz;
+	}
+
+public:
+	class iterator {
+		friend flat_map;
+	private:
+		const flat_map *m; size_t i;
+	public:
+		struct pointer { // what operator-> gives: the pair of references, which points to itself
+			reference r;
+			reference *operator->() {return &r;}
+		};
+		iterator() {}
+		iterator(const flat_map *y, size_t j) : m(y), i(j) {}
+		iterator(const iterator &other) : m(other.m), i(other.i) {}
+		iterator & operator++() {
+			if (i == m->sz) throw invalid_iterator();
+			i++;
+			return *this;
+		}
+		iterator operator++(int) {
+			iterator ret = *this;
+			++(*this);
+			return ret;
+		}
+		iterator & operator--() {
+			if (!i) throw invalid_iterator();
+			i--;
+			return *this;
+		}
+		iterator operator--(int) {
+			iterator ret = *this;
+			--(*this);
+			return ret;
+		}
+		reference operator*() const {if (i == m->sz) throw invalid_iterator(); return reference(m->K[i], m->V[i]);}
+		pointer operator->() const noexcept {return pointer{reference(m->K[i], m->V[i])};}
+		bool operator==(const iterator &rhs) const {return i == rhs.i && m == rhs.m;}
+		bool operator!=(const iterator &rhs) const {return !(*this == rhs);}
+	};
+
+	class const_iterator {
+		private:
+			iterator x;
+		public:
+			struct pointer {
+				const_reference r;
+				const_reference *operator->() {return &r;}
+			};
+			const_iterator() {}
+			const_iterator(const iterator &other) : x(other) {}
+			const_iterator(const const_iterator &other) : x(other.x) {}
+			const_iterator & operator ++ ()  {++x; return *this;}
+			const_iterator operator ++ (int) {const_iterator ret(*this); ++x; return ret;}
+			const_iterator & operator -- ()  {--x; return *this;}
+			const_iterator operator -- (int) {const_iterator ret(*this); --x; return ret;}
+			const_reference operator*() const {reference r = *x; return const_reference(r.first, r.second);}
+			pointer operator->() const noexcept {return pointer{**this};}
+			bool operator==(const const_iterator &rhs) const {return x == rhs.x;}
+			bool operator!=(const const_iterator &rhs) const {return x != rhs.x;}
+			friend bool operator==(const const_iterator &lhs, const iterator &rhs) {return lhs.x == rhs;}
+			friend bool operator==(const iterator &lhs, const const_iterator &rhs) {return lhs == rhs.x;}
+			friend bool operator!=(const const_iterator &lhs, const iterator &rhs) {return lhs.x != rhs;}
+			friend bool operator!=(const iterator &lhs, const const_iterator &rhs) {return lhs != rhs.x;}
+	};
+
+	inline iterator iter(size_t i) const {
+		return iterator(this, i);
+	}
+	inline void shared_construct() {
+		K = NULL, V = NULL;
+		sz = cap = 0;
+	}
+	void clear() {
+		free_all();
+		shared_construct();
+	}
+	flat_map() {
+		shared_construct();
+	}
+	template <class InputIterator>
+	flat_map(InputIterator first, InputIterator last) {
+		shared_construct();
+		insert(first, last);
+	}
+	flat_map(const flat_map &other) {
+		shared_construct();
+		copy(other);
+	}
+	flat_map & operator=(const flat_map &other) {
+		if (this != &other) {
+			clear();
+			copy(other);
+		}
+		return *this;
+	}
+	~flat_map() {
+		free_all();
+	}
+	void reserve(size_t n) {
+		if (n > cap) grow(n);
+	}
+	T & at(const Key &key) {
+		size_t i = search(key);
+		if (i == sz) throw index_out_of_bound();
+		return V[i];
+	}
+	const T & at(const Key &key) const {
+		size_t i = search(key);
+		if (i == sz) throw index_out_of_bound();
+		return V[i];
+	}
+	T & operator[](const Key &key) {
+		size_t i = lower(key);
+		if (i == sz || less(key, K[i])) i = put(i, key, T()); // put may move V
+		return V[i];
+	}
+	const T & operator[](const Key &key) const {return at(key);}
+	iterator begin() const {return iter(0);}
+	const_iterator cbegin() const {return const_iterator(begin());}
+	iterator end() const {return iter(sz);}
+	const_iterator cend() const {return const_iterator(end());}
+	bool empty() const {return sz == 0;}
+	int size() const {return sz;}
+	pair<iterator, bool> insert(const value_type &value) {
+		size_t i = lower(value.first);
+		if (i < sz && !less(value.first, K[i])) return {iter(i), 0};
+		return {iter(put(i, value.first, value.second)), 1};
+	}
+	/**
+	 * insert [first, last) of value_type all at once: appended, then sorted
+	 * and merged in one pass, O((n + m) + m log m) for m new elements. a range
+	 * that is sorted and after every key is only appended. as with insert,
+	 * a key already present, or met before in the range, is not inserted.
+	 */
+	template <class InputIterator>
+	void insert(InputIterator first, InputIterator last) {
+		size_t n = sz;
+		bool sorted = true;
+		for (; first != last; ++first) {
+			if (sz == cap) grow(cap ? cap * 2 : 8);
+			new(K + sz) Key((*first).first);
+			new(V + sz) T((*first).second);
+			if (sz && sorted && !less(K[sz - 1], K[sz])) sorted = false;
+			sz++;
+		}
+		if (!sorted) settle(n);
+	}
+	void erase(iterator pos) {
+		if (pos.m != this || pos.i >= sz) throw invalid_iterator();
+		del(pos.i);
+	}
+	/**
+	 * erase the element of key if there is one.
+	 * @return the number of elements erased, 0 or 1.
+	 */
+	size_t erase(const Key &key) {
+		size_t i = search(key);
+		if (i == sz) return 0;
+		del(i);
+		return 1;
+	}
+	size_t count(const Key &key) const {return search(key) != sz;}
+	iterator find(const Key &key) {return iter(search(key));}
+	const_iterator find(const Key &key) const {return iter(search(key));}
+	iterator lower_bound(const Key &key) {return iter(lower(key));}
+	const_iterator lower_bound(const Key &key) const {return iter(lower(key));}
+	iterator upper_bound(const Key &key) {return iter(upper(key));}
+	const_iterator upper_bound(const Key &key) const {return iter(upper(key));}
+};
+}
+
+#endif
@@ -0,0 +1,402 @@
+/**
+ * a hash map that remembers the order of its elements, for lru caches
+ */
+
+#ifndef SJTU_LINKED_HASHMAP_HPP
+#define SJTU_LINKED_HASHMAP_HPP
+
+#include <functional>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+/**
+ * chained hash buckets, with every node also on a doubly linked list that
+ * iterates in insertion order, or in access order: a non-const lookup or
+ * insert of a present key then moves it to the back, so the front is the
+ * least recently used. the const lookups never move anything.
+ * with a capacity, inserting into a full map drops the front element.
+ * find, erase, move_to_back and pop_front are O(1) on average. nodes never
+ * move, so iterators stay valid until their element is erased.
+ */
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class KeyEqual = std::equal_to<Key>
+> class linked_hashmap {
+
+public:
+	class const_iterator;
+	class iterator;
+	typedef sjtu::pair<const Key, T> value_type;
+
+private:
+	struct Node {
+		Node *chain; // the next in the bucket
+		Node *pre, *nxt; // as a list node
+		size_t h;
+		typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type mem;
+		value_type & v() {return *(value_type *)&mem;}
+		const value_type & v() const {return *(const value_type *)&mem;}
+	};
+
+	class allocator {
+		// as the allocator of sjtu::map: nodes are cut from slabs in order,
+		// and freed nodes go to the pool and are reused first
+		struct slab {
+			slab *nxt; Node *mem;
+		};
+		slab *slabs;
+		Node *pool, *cur;
+		size_t left, grow;
+	public:
+		allocator () {slabs = NULL; pool = cur = NULL; left = 0; grow = 8;}
+		~allocator () { // every node is in the pool by now
+			while (slabs) {
+				slab *y = slabs;
+				slabs = y->nxt;
+				operator delete(y->mem);
+				delete y;
+			}
+		}
+		void reserve(size_t n) { // the next n new nodes allocate nothing: the pool, then one slab
+			size_t k = pooled();
+			if (n <= k) return;
+			n -= k;
+			for (; left; left--) cur->nxt = pool, pool = cur++; // what is left of the slab is used first
+			slab *y = new slab;
+			y->mem = cur = (Node *)operator new(sizeof(Node) * n);
+			y->nxt = slabs, slabs = y;
+			left = n;
+		}
+		template <class... Args>
+		Node *New(Args&&... args) { // construct the value in place from args
+			Node *ret = pool;
+			if (ret) pool = ret->nxt;
+			else {
+				if (!left) {
+					reserve(grow);
+					if (grow < 4096) grow <<= 1;
+				}
+				ret = cur++, left--;
+			}
+			new(&ret->mem) value_type(std::forward<Args>(args)...);
+			return ret;
+		}
+		void Del(Node *y) {
+			y->v().~value_type();
+			y->nxt = pool, pool = y;
+		}
+		size_t pooled() const {
+			size_t n = left;
+			for (Node *x = pool; x; x = x->nxt) n++;
+			return n;
+		}
+	};
+
+	allocator M;
+	Node head; // the list sentinel, end()
+	Node **b; size_t nb; // nb buckets, a power of 2, or none yet
+	size_t cap; // 0 for no bound
+	bool access;
+	int sz;
+	Hash hasher;
+	KeyEqual eq;
+
+	size_t hash(const Key &k) const {return mix_hash(hasher(k));}
+
+	Node *search(const Key &k, size_t h) const { // the node of k or NULL
+		if (!nb) return NULL;
+		for (Node *x = b[h & (nb - 1)]; x; x = x->chain)
+			if (x->h == h && eq(x->v().first, k)) return x;
+		return NULL;
+	}
+
+	Node *touch(Node *x) { // in access order, x is used now
+		if (access) {
+			unlink(x);
+			link(x);
+		}
+		return x;
+	}
+
+	Node *get(const Key &k) {
+		Node *x = search(k, hash(k));
+		return x ? touch(x) : NULL;
+	}
+
+	void link(Node *x) { // at the back
+		x->pre = head.pre, x->nxt = &head;
+		head.pre->nxt = x, head.pre = x;
+	}
+
+	void unlink(Node *x) {
+		x->pre->nxt = x->nxt;
+		x->nxt->pre = x->pre;
+	}
+
+	void rehash(size_t n) { // to n buckets
+		Node **c = new Node*[n]();
+		for (Node *x = head.nxt; x != &head; x = x->nxt) {
+			Node *&y = c[x->h & (n - 1)];
+			x->chain = y, y = x;
+		}
+		delete [] b;
+		b = c, nb = n;
+	}
+
+	Node *add(Node *x, size_t h) { // a new node x of hash h, at the back
+		if ((size_t)sz >= nb) rehash(nb ? nb * 2 : 16);
+		x->h = h;
+		Node *&y = b[h & (nb - 1)];
+		x->chain = y, y = x;
+		link(x);
+		sz++;
+		if (cap && (size_t)sz > cap) del(head.nxt);
+		return x;
+	}
+
+	void del(Node *x) {
+		Node **y = &b[x->h & (nb - 1)];
+		while (*y != x) y = &(*y)->chain;
+		*y = x->chain;
+		unlink(x);
+		M.Del(x);
+		sz--;
+	}
+
+	void shared_construct() {
+		head.pre = head.nxt = &head;
+		b = NULL, nb = 0;
+		sz = 0;
+	}
+
+	void copy(const linked_hashmap &other) { // into an empty map, in the same order
+		M.reserve(other.sz);
+		for (Node *x = other.head.nxt; x != &other.head; x = x->nxt) add(M.New(x->v()), x->h);
+	}
+
+public:
+	class iterator {
+		friend linked_hashmap;
+	private:
+		Node *x, *e; // e: the head of the map
+	public:
+		iterator() {}
+		iterator(Node *y, Node *f) : x(y), e(f) {}
+		iterator(const iterator &other) : x(other.x), e(other.e) {}
+		iterator & operator++() {
+			if (x == e) throw invalid_iterator();
+			x = x->nxt;
+			return *this;
+		}
+		iterator operator++(int) {
+			iterator ret = *this;
+			++(*this);
+			return ret;
+		}
+		iterator & operator--() {
+			if (x->pre == e) throw invalid_iterator();
+			x = x->pre;
+			return *this;
+		}
+		iterator operator--(int) {
+			iterator ret = *this;
+			--(*this);
+			return ret;
+		}
+		value_type & operator*() const {if (x == e) throw invalid_iterator(); return x->v();}
+		value_type* operator->() const noexcept {return &x->v();}
+		bool operator==(const iterator &rhs) const {return x == rhs.x;}
+		bool operator!=(const iterator &rhs) const {return x != rhs.x;}
+	};
+
+	class const_iterator {
+		private:
+			iterator x;
+		public:
+			const_iterator() {}
+			const_iterator(const iterator &other) : x(other) {}
+			const_iterator(const const_iterator &other) : x(other.x) {}
+			const_iterator & operator ++ ()  {++x; return *this;}
+			const_iterator operator ++ (int) {const_iterator ret(*this); ++x; return ret;}
+			const_iterator & operator -- ()  {--x; return *this;}
+			const_iterator operator -- (int) {const_iterator ret(*this); --x; return ret;}
+			const value_type & operator*() const {return *x;}
+			const value_type* operator->() const noexcept {return &(*x);}
+			bool operator==(const const_iterator &rhs) const {return x == rhs.x;}
+			bool operator!=(const const_iterator &rhs) const {return x != rhs.x;}
+			friend bool operator==(const const_iterator &lhs, const iterator &rhs) {return lhs.x == rhs;}
+			friend bool operator==(const iterator &lhs, const const_iterator &rhs) {return lhs == rhs.x;}
+			friend bool operator!=(const const_iterator &lhs, const iterator &rhs) {return lhs.x != rhs;}
+			friend bool operator!=(const iterator &lhs, const const_iterator &rhs) {return lhs != rhs.x;}
+	};
+
+	inline iterator iter(const Node *x) const {
+		return iterator(const_cast<Node *>(x), const_cast<Node *>(&head));
+	}
+	void clear() {
+		while (head.nxt != &head) {
+			Node *x = head.nxt;
+			head.nxt = x->nxt;
+			M.Del(x);
+		}
+		delete [] b;
+		shared_construct();
+	}
+	/**
+	 * in insertion order, without a bound.
+	 */
+	linked_hashmap() {
+		cap = 0, access = false;
+		shared_construct();
+	}
+	/**
+	 * access_order: iterate from the least recently used to the most.
+	 * capacity: the most elements kept, 0 for no bound. with access order
+	 * this is an lru cache.
+	 */
+	explicit linked_hashmap(bool access_order, size_t capacity = 0, const Hash &h = Hash(), const KeyEqual &e = KeyEqual())
+		: hasher(h), eq(e) {
+		cap = capacity, access = access_order;
+		shared_construct();
+	}
+	linked_hashmap(const linked_hashmap &other) : hasher(other.hasher), eq(other.eq) {
+		cap = other.cap, access = other.access;
+		shared_construct();
+		copy(other);
+	}
+	linked_hashmap & operator=(const linked_hashmap &other) {
+		if (this != &other) {
+			clear();
+			cap = other.cap, access = other.access;
+			hasher = other.hasher, eq = other.eq;
+			copy(other);
+		}
+		return *this;
+	}
+	~linked_hashmap() {
+		clear();
+	}
+	/**
+	 * make room for n elements in all, buckets and nodes, so that inserting
+	 * up to n allocates nothing.
+	 */
+	void reserve(size_t n) {
+		size_t m = nb ? nb : 16;
+		while (m < n) m <<= 1;
+		if (m > nb) rehash(m);
+		if (n > (size_t)sz) M.reserve(n - sz);
+	}
+	/**
+	 * the non-const lookups count as a use in access order.
+	 */
+	T & at(const Key &key) {
+		Node *x = get(key);
+		if (!x) throw index_out_of_bound();
+		return x->v().second;
+	}
+	const T & at(const Key &key) const {
+		Node *x = search(key, hash(key));
+		if (!x) throw index_out_of_bound();
+		return x->v().second;
+	}
+	T & operator[](const Key &key) {return try_emplace(key).first->second;}
+	const T & operator[](const Key &key) const {return at(key);}
+	iterator begin() const {return iter(head.nxt);}
+	const_iterator cbegin() const {return const_iterator(begin());}
+	iterator end() const {return iter(&head);}
+	const_iterator cend() const {return const_iterator(end());}
+	bool empty() const {return sz == 0;}
+	int size() const {return sz;}
+	/**
+	 * the first and the last in order: with access order, the least and the
+	 * most recently used.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	value_type & front() {
+		if (!sz) throw container_is_empty();
+		return head.nxt->v();
+	}
+	value_type & back() {
+		if (!sz) throw container_is_empty();
+		return head.pre->v();
+	}
+	pair<iterator, bool> insert(const value_type &value) {
+		size_t h = hash(value.first);
+		Node *x = search(value.first, h);
+		if (x) return {iter(touch(x)), 0};
+		return {iter(add(M.New(value), h)), 1};
+	}
+	pair<iterator, bool> insert(value_type &&value) {
+		size_t h = hash(value.first);
+		Node *x = search(value.first, h);
+		if (x) return {iter(touch(x)), 0};
+		return {iter(add(M.New(std::move(value)), h)), 1};
+	}
+	/**
+	 * insert (k, T(args...)) only if k is absent; args are untouched otherwise.
+	 */
+	template <class... Args>
+	pair<iterator, bool> try_emplace(const Key &k, Args&&... args) {
+		size_t h = hash(k);
+		Node *x = search(k, h);
+		if (x) return {iter(touch(x)), 0};
+		return {iter(add(M.New(k, T(std::forward<Args>(args)...)), h)), 1};
+	}
+	template <class... Args>
+	pair<iterator, bool> try_emplace(Key &&k, Args&&... args) {
+		size_t h = hash(k);
+		Node *x = search(k, h);
+		if (x) return {iter(touch(x)), 0};
+		return {iter(add(M.New(std::move(k), T(std::forward<Args>(args)...)), h)), 1};
+	}
+	void erase(iterator pos) {
+		if (pos.e != &head || pos.x == &head) throw invalid_iterator();
+		del(pos.x);
+	}
+	/**
+	 * erase the element of key if there is one.
+	 * @return the number of elements erased, 0 or 1.
+	 */
+	size_t erase(const Key &key) {
+		Node *x = search(key, hash(key));
+		if (!x) return 0;
+		del(x);
+		return 1;
+	}
+	/**
+	 * erase the first element in order, the least recently used with access order.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	void pop_front() {
+		if (!sz) throw container_is_empty();
+		del(head.nxt);
+	}
+	/**
+	 * move pos to the back, as if it were just inserted or used.
+	 */
+	void move_to_back(iterator pos) {
+		if (pos.e != &head || pos.x == &head) throw invalid_iterator();
+		unlink(pos.x);
+		link(pos.x);
+	}
+	size_t count(const Key &key) const {return search(key, hash(key)) != NULL;}
+	iterator find(const Key &key) {
+		Node *x = get(key);
+		return x ? iter(x) : end();
+	}
+	const_iterator find(const Key &key) const {
+		Node *x = search(key, hash(key));
+		return x ? iter(x) : end();
+	}
+};
+}
+
+#endif
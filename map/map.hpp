@@ -8,6 +8,7 @@
 
 #include <functional>
 #include <cstddef>
+#include <tuple>
 #include "utility.hpp"
 #include "exceptions.hpp"
 
@@ -30,8 +31,10 @@ public:
 
 private:
 
-	allocator M;
-	Node end_node, nil, *null, *rt, *End;
+	allocator M, old; // old: where the nodes not yet moved by a defragment pass live
+	Node *cursor; // the next node the pass moves, or NULL with no pass
+	static Node nil; // shared by all maps of a type, so nodes can move between them
+	Node end_node, *null, *rt, *End;
 	int sz;
 
 	struct Node {
@@ -39,11 +42,8 @@ private:
 		Node *pre, *nxt; // as a list node
 		char mem[sizeof(value_type)];
 		bool aux;
+		int s; // size of the subtree, End included
 		Node () {aux = true;}
-		Node (const value_type &z) {
-			aux = false;
-			new(mem) value_type(z);
-		}
 		~Node () {
 			if (!aux) v().~value_type();
 		}
@@ -56,47 +56,143 @@ private:
 		bool operator < (const Node &b) const {
 			return aux == b.aux ? Compare()(v().first, b.v().first) : aux < b.aux;
 		}
-		friend bool operator < (const Key &a, const Node &n) {
+		template <class K> // Key, or anything Compare takes with Key if it is transparent
+		friend bool operator < (const K &a, const Node &n) {
 			return n.aux ? 1 : Compare()(a, n.v().first);
 		}
-		
-		friend bool operator < (const Node &n, const Key &a) {
+		template <class K>
+		friend bool operator < (const Node &n, const K &a) {
 			return n.aux ? 0 : Compare()(n.v().first, a);
 		}
 		bool d() const{
 			return this == fa->c[1];
 		}
-		void setc(Node *ch, const int& p) {
-			c[p] = ch; ch->fa = this;
+		void setc(Node *ch, const int& p) { // nil is never written
+			c[p] = ch;
+			if (ch != &nil) ch->fa = this;
+		}
+		void pull() {
+			s = c[0]->s + c[1]->s + 1;
 		}
 	};
 
 	class allocator {
-		// It is only a homework, so I don't want to implement a robust memory pool
-		Node *pool;
-	public:
-		allocator () {pool = NULL;}
-		~allocator () {
-			while (pool) {
-				Node *x = pool;
-				pool = pool->nxt;
-				x->aux = 1;
+		// nodes are cut from slabs in order, so nodes allocated together are
+		// contiguous; freed nodes go to the pool and are reused first.
+		// maps that trade nodes by split or join share one arena, which lives
+		// until the last of them is gone. an absorbed arena forwards to the
+		// one that took its slabs, and its maps follow on their next call.
+		struct slab {
+			slab *nxt; Node *mem;
+		};
+		struct arena {
+			arena *fwd;
+			size_t cnt; // the maps and arenas pointing here
+			slab *slabs, *first;
+			Node *pool, *tail, *cur;
+			size_t left, grow;
+			arena () {fwd = NULL; cnt = 1; slabs = first = NULL; pool = tail = cur = NULL; left = 0; grow = 8;}
+		};
+		arena *a;
+		static void release(arena *x) {
+			while (x && !--x->cnt) {
+				while (x->slabs) {
+					slab *y = x->slabs;
+					x->slabs = y->nxt;
+					operator delete(y->mem);
+					delete y;
+				}
+				arena *f = x->fwd;
 				delete x;
+				x = f;
 			}
 		}
-		Node *New(const value_type &v, Node *null = NULL) {
-			Node *ret = pool;
-			if (pool) {
-				pool = pool->nxt;
-				new(ret->mem) value_type(v);
-			} else ret = new Node(v);
+		arena *get() { // the arena in use, created on the first call
+			if (!a) a = new arena;
+			while (a->fwd) {
+				arena *f = a->fwd;
+				f->cnt++;
+				release(a);
+				a = f;
+			}
+			return a;
+		}
+	public:
+		allocator () {a = NULL;}
+		~allocator () {release(a);} // every node of this map is in a pool by now
+		void reserve(size_t n) { // the next n new nodes allocate nothing: the pool, then one slab
+			arena *x = get();
+			size_t k = x->left;
+			for (Node *y = x->pool; y && k < n; y = y->nxt) k++;
+			if (n <= k) return;
+			n -= k;
+			for (; x->left; x->left--) { // what is left of the slab is used first
+				if (!x->pool) x->tail = x->cur;
+				x->cur->nxt = x->pool, x->pool = x->cur++;
+			}
+			slab *y = new slab;
+			y->mem = x->cur = (Node *)operator new(sizeof(Node) * n);
+			y->nxt = x->slabs, x->slabs = y;
+			if (!x->first) x->first = y;
+			x->left = n;
+		}
+		template <class... Args>
+		Node *New(Node *null, Args&&... args) { // construct the value in place from args
+			arena *x = get();
+			Node *ret = x->pool;
+			if (ret) x->pool = ret->nxt;
+			else {
+				if (!x->left) {
+					reserve(x->grow);
+					if (x->grow < 4096) x->grow <<= 1;
+				}
+				ret = x->cur++, x->left--;
+			}
+			new(ret) Node();
+			new(ret->mem) value_type(std::forward<Args>(args)...);
+			ret->aux = false;
+			ret->s = 1;
 			ret->fa = ret->c[0] = ret->c[1] = null;
 			ret->pre = ret->nxt = ret;
 			return ret;
 		}
-		void Del(Node *x) {
-			x->~Node();
-			x->nxt = pool, pool = x;
+		void Del(Node *y) {
+			arena *x = get();
+			y->~Node();
+			if (!x->pool) x->tail = y;
+			y->nxt = x->pool, x->pool = y;
+		}
+		void swap(allocator &o) {
+			arena *x = a;
+			a = o.a, o.a = x;
+		}
+		void drop() { // let go of the arena
+			release(a);
+			a = NULL;
+		}
+		void share(allocator &o) { // use the arena of o from now on
+			arena *x = o.get();
+			x->cnt++;
+			release(a);
+			a = x;
+		}
+		void absorb(allocator &o) { // take the slabs and pool of o, whose nodes may now come here
+			arena *x = get(), *y = o.get();
+			if (x == y) return;
+			if (y->slabs) {
+				y->first->nxt = x->slabs, x->slabs = y->slabs;
+				if (!x->first) x->first = y->first;
+			}
+			if (y->pool) {
+				if (!x->pool) x->tail = y->tail;
+				y->tail->nxt = x->pool, x->pool = y->pool;
+			}
+			if (y->left > x->left) x->cur = y->cur, x->left = y->left;
+			if (y->grow > x->grow) x->grow = y->grow;
+			y->slabs = y->first = NULL;
+			y->pool = y->tail = NULL;
+			y->left = 0;
+			y->fwd = x, x->cnt++;
 		}
 	};
 
@@ -109,24 +205,74 @@ private:
 		sz++;
 	}
 
-	void del(Node *x) { // x as a leaf
-		x->fa->setc(null, x->d());
+	void del(Node *x) { // splay x, put its predecessor in its place, and free it
+		splay(x);
+		Node *y = x->c[1];
+		if (x->c[0] != null) {
+			y = splay(x->pre, x);
+			y->setc(x->c[1], 1);
+			y->pull();
+		}
+		y->fa = null, rt = y;
+		del_(x);
+	}
+	void link(Node *x, Node *y) { // x as a list node before y, tree links are left to build
+		x->pre = y->pre, x->nxt = y;
+		y->pre->nxt = x, y->pre = x;
+		sz++;
+	}
+
+	void append(Node *x) { // x as a list node at the back
+		link(x, End);
+	}
+
+	void unlink(Node *x) { // x out of the list, tree links are left to build
 		x->nxt->pre = x->pre, x->pre->nxt = x->nxt;
-		M.Del(x);
 		sz--;
 	}
+
+	void free_node(Node *x) { // every node is freed here
+		if (!cursor) {
+			M.Del(x);
+			return;
+		}
+		// a pass is on and x may be in either arena: drop the slot, it goes with its slab
+		if (x == cursor) cursor = x->nxt;
+		x->~Node();
+	}
+
 	void del_(Node *x) { // x as a list node when clear
-		x->nxt->pre = x->pre, x->pre->nxt = x->nxt;
-		M.Del(x);
-		sz--;
+		unlink(x);
+		free_node(x);
+	}
+
+	Node* relocate(Node *x) { // move x to a new node from M, in its place in the tree and the list
+		Node *y = M.New(null, std::move(x->v()));
+		y->s = x->s;
+		if (x->fa == null) rt = y, y->fa = null;
+		else x->fa->setc(y, x->d());
+		y->setc(x->c[0], 0), y->setc(x->c[1], 1);
+		y->pre = x->pre, y->nxt = x->nxt;
+		x->pre->nxt = y, x->nxt->pre = y;
+		x->~Node();
+		return y;
+	}
+
+	void settle() { // end a defragment pass early, taking both arenas as one: before nodes change maps
+		if (!cursor) return;
+		M.absorb(old);
+		old.drop();
+		cursor = NULL;
 	}
 
 	void rot(Node *x) {
 		Node *fa = x->fa;
 		int d = x->d();
-		fa->fa->setc(x, fa->d());
+		if (fa == rt) x->fa = null;
+		else fa->fa->setc(x, fa->d());
 		fa->setc(x->c[!d], d);
 		x->setc(fa, !d);
+		fa->pull(), x->pull();
 		if (fa == rt) rt = x;
 	}
 	
@@ -139,34 +285,178 @@ private:
 		return x;
 	}
 
+	Node* build(Node *&cur, int n) { // the next n list nodes from cur as a balanced tree
+		if (!n) return null;
+		Node *l = build(cur, n / 2), *x = cur;
+		cur = cur->nxt;
+		x->setc(l, 0);
+		x->setc(build(cur, n - n / 2 - 1), 1);
+		x->pull();
+		return x;
+	}
+
 #define binary_search() while (x != null) {\
 			if (k < *x) y = x, x = x->c[0];\
 			else if (*x < k) y = x, x = x->c[1];\
 			else return splay(x);\
 		}
 	
-	inline Node* get(const Key &k) { // return pointer or End
+	template <class K>
+	inline Node* get(const K &k) { // return pointer or End
 		Node *x = rt, *y = null;
 		binary_search();
 		if (y != null) splay(y);
 		return End;
 	}
 
-	inline Node* tget(const Key &k) { // [throw] return pointer or throw
+	template <class K>
+	inline Node* tget(const K &k) { // [throw] return pointer or throw
 		Node *x = rt, *y = null;
 		binary_search();
 		if (y != null) splay(y);
 		throw index_out_of_bound();
 	}
 
+	template <class K>
+	inline Node* search(const K &k) const { // return pointer or End, without splaying
+		Node *x = rt;
+		while (x != null) {
+			if (k < *x) x = x->c[0];
+			else if (*x < k) x = x->c[1];
+			else return x;
+		}
+		return End;
+	}
+
+	template <class K>
+	inline Node* tsearch(const K &k) const { // [throw] return pointer or throw, without splaying
+		Node *x = search(k);
+		if (x == End) throw index_out_of_bound();
+		return x;
+	}
+
+	template <class K>
+	Node* bound(const K &k, bool up, Node *&last) const { // the first node not less (greater if up) than k
+		Node *x = rt, *y = End;
+		while (x != null) {
+			last = x;
+			if (up ? k < *x : !(*x < k)) y = x, x = x->c[0];
+			else x = x->c[1];
+		}
+		return y;
+	}
+
+	template <class K>
+	Node* sbound(const K &k, bool up) { // bound, and splay the last node on the path
+		Node *last = rt, *y = bound(k, up, last);
+		splay(last);
+		return y;
+	}
+
+	Node* gap(Node *h) const { // the parent to add under for a key between h->pre and h
+		return h->c[0] == null ? h : h->pre;
+	}
+
+	bool fits(Node *h, const Key &k) const { // whether k goes right before h
+		return k < *h && (h->pre == End || *h->pre < k);
+	}
+
+	Node* place(const Key &k, Node *&y) { // return the node of k, or null with y as the parent to add under
+		if (sz && *End->pre < k) { // past the last key, as with ascending input: no search
+			y = gap(End);
+			return null;
+		}
+		Node *x = rt;
+		y = null;
+		while (x != null) {
+			if (k < *x) y = x, x = x->c[0];
+			else if (*x < k) y = x, x = x->c[1];
+			else return x;
+		}
+		return null;
+	}
+
+	int order(Node *x) const { // the index of x in key order, End being sz
+		int ret = x->c[0]->s;
+		for (; x->fa != null; x = x->fa) if (x->d()) ret += x->fa->c[0]->s + 1;
+		return ret;
+	}
+
+	Node* kth(int k) const { // the node of index k in [0, sz], End for sz
+		Node *x = rt;
+		for (;;) {
+			int l = x->c[0]->s;
+			if (k < l) x = x->c[0];
+			else if (k == l) return x;
+			else k -= l + 1, x = x->c[1];
+		}
+	}
+
+	void cut(const Key &k, bool up, map &ret) { // move the keys not less (greater if up) than k into the empty ret
+		settle();
+		Node *last = rt, *y = bound(k, up, last);
+		if (y == End) {
+			splay(last);
+			return;
+		}
+		ret.M.share(M);
+		splay(End);
+		splay(y, End); // y->c[0] is what stays, y and y->c[1] leave
+		Node *l = y->c[0], *p = y->pre, *z = End->pre;
+		End->setc(l, 0);
+		y->c[0] = null;
+		y->pull(), End->pull();
+		ret.End->setc(y, 0);
+		ret.End->pull();
+		ret.sz = y->s;
+		sz -= y->s;
+		ret.End->nxt = y, y->pre = ret.End;
+		z->nxt = ret.End, ret.End->pre = z;
+		p->nxt = End, End->pre = p;
+	}
+
+	void isolate(const map &other, map &m, map &r) { // move the keys within the range of other to m, those above to r
+		cut(other.End->nxt->v().first, 0, m);
+		m.cut(other.End->pre->v().first, 1, r);
+	}
+
+	void rejoin(map &m, map &r) { // undo isolate: m, rebuilt from its list, and r back into this
+		m.rebalance();
+		join(std::move(m));
+		join(std::move(r));
+	}
+
+	bool apart(const map &other) const { // whether the key ranges do not overlap
+		return !sz || !other.sz || *End->pre < other.End->nxt->v().first || *other.End->pre < End->nxt->v().first;
+	}
+
+	int less(const Key &k, Node *&last) const { // the number of keys less than k
+		Node *x = rt;
+		int ret = 0;
+		while (x != null) {
+			last = x;
+			if (*x < k) ret += x->c[0]->s + 1, x = x->c[1];
+			else x = x->c[0];
+		}
+		return ret;
+	}
+
+	template <class... Args>
+	Node* put(Node *y, Args&&... args) { // a new node under y, splayed
+		Node *x = M.New(null, std::forward<Args>(args)...);
+		add(x, y, *y < x->v().first);
+		return splay(x);
+	}
+
 	inline Node* nget(const Key &k) { // [new] return pointer and new if needed
+		if (sz && *End->pre < k) return put(gap(End), std::piecewise_construct, std::forward_as_tuple(k), std::tuple<>());
 		Node *x = rt, *y = null;
 		binary_search();
 		bool d = *y < k;
-		add(x = M.New(value_type(k, T()), null), y, d);
+		add(x = M.New(null, std::piecewise_construct, std::forward_as_tuple(k), std::tuple<>()), y, d);
 		return splay(x);
 	}
-
+#undef binary_search // do not clash with std::binary_search from <algorithm>
 
 public:
 	class iterator {
@@ -196,6 +486,7 @@ public:
 	};
 
 	class const_iterator {
+		friend map;
 		private:
 			iterator x;
 		public:
@@ -219,31 +510,47 @@ public:
 	inline iterator iter(Node* x) const {
 		return iterator(x, End);
 	}
-	inline void insert_all(const map &other) {
-		for (auto v : other) insert(v);
+	inline void insert_all(const map &other) { // O(n): copy the list, then build a balanced tree
+		M.reserve(other.sz);
+		for (Node *x = other.End->nxt; x != other.End; x = x->nxt) append(M.New(null, x->v()));
+		rebalance();
 	}
-	void clear() {
-		while (End->nxt != End) del_(End->nxt);
+	void reset() { // End alone; the nodes are freed or owned elsewhere
 		sz = 0;
 		rt = End;
+		rt->s = 1;
 		rt->pre = rt->nxt = rt;
 		rt->fa = rt->c[0] = rt->c[1] = null;
 	}
+	void clear() {
+		settle();
+		while (End->nxt != End) del_(End->nxt);
+		reset();
+	}
 	inline void shared_construct() {
-		sz = 0;
-
+		cursor = NULL;
 		null = &nil;
-		null->nxt = null->pre = null;
-		null->fa = null->c[0] = null->c[1] = null;
 		End = &end_node;
-
-		End->nxt = End->pre = End;
-		End->fa = End->c[0] = End->c[1] = null;
-		rt = End;
+		reset();
 	}
 	map() {
 		shared_construct();
 	}
+	/**
+	 * construct from [first, last) of value_type.
+	 * a sorted range is built into a balanced tree in O(n); should a key be
+	 * out of order, the elements from it on are inserted one by one.
+	 */
+	template <class InputIterator>
+	map(InputIterator first, InputIterator last) {
+		shared_construct();
+		for (; first != last; ++first) {
+			if (sz && !(*End->pre < (*first).first)) break;
+			append(M.New(null, *first));
+		}
+		rebalance();
+		for (; first != last; ++first) insert(*first);
+	}
 	map(const map &other) {
 		shared_construct();
 		insert_all(other);
@@ -255,13 +562,81 @@ public:
 		}
 		return *this;
 	}
+	/**
+	 * take over the elements of other in amortized O(logn), as join does:
+	 * no element is copied, other is left empty, and the two share a node arena.
+	 */
+	map(map &&other) {
+		shared_construct();
+		join(std::move(other));
+	}
+	map & operator=(map &&other) {
+		if (this != &other) {
+			clear();
+			join(std::move(other));
+		}
+		return *this;
+	}
 	~map() {
 		clear();
 	}
+	/**
+	 * lookups through a const map are a plain binary search and never splay,
+	 * so several threads may read a map that no one is writing to.
+	 * the non-const ones splay the found node to the root.
+	 * a splay tree can be arbitrarily deep, so call rebalance() before
+	 * handing a map to readers.
+	 */
+	void rebalance() {
+		Node *cur = End->nxt;
+		rt = build(cur, sz + 1);
+		rt->fa = null;
+	}
+	/**
+	 * after much churn, nodes reused from the pool are scattered and scans
+	 * miss the cache on every node. this moves the nodes, in key order, into
+	 * one new slab and lets go of the old ones, which are freed unless maps
+	 * split from or joined with this one still use them.
+	 * every iterator is invalidated.
+	 */
+	void defragment() {defragment((size_t)-1);}
+	/**
+	 * the same as an incremental pass: move at most steps nodes per call,
+	 * the map staying usable in between. nodes made during the pass come from
+	 * the new slabs as well. iterators to the moved nodes are invalidated.
+	 * split, join and the set operations end a pass early.
+	 * @return true when the pass is complete.
+	 */
+	bool defragment(size_t steps) {
+		if (!cursor) {
+			if (!sz) return true;
+			M.swap(old);
+			M.reserve(sz);
+			cursor = End->nxt;
+		}
+		for (; steps && cursor != End; steps--) cursor = relocate(cursor)->nxt;
+		if (cursor != End) return false;
+		old.drop();
+		cursor = NULL;
+		return true;
+	}
 	T & at(const Key &key) {return tget(key)->v().second;}
-	const T & at(const Key &key) const {return const_cast<map*>(this)->tget(key)->v().second;}
+	const T & at(const Key &key) const {return tsearch(key)->v().second;}
+	/**
+	 * with a transparent Compare (one that has is_transparent, like std::less<>),
+	 * the lookups below also take any K that Compare can order against Key,
+	 * and no temporary Key is made.
+	 */
+	template <class K, class C = Compare, class = typename C::is_transparent>
+	T & at(const K &key) {return tget(key)->v().second;}
+	template <class K, class C = Compare, class = typename C::is_transparent>
+	const T & at(const K &key) const {return tsearch(key)->v().second;}
 	T & operator[](const Key &key) {return nget(key)->v().second;}
-	const T & operator[](const Key &key) const {return const_cast<map*>(this)->tget(key)->v().second;}
+	T & operator[](Key &&key) {
+		Node *y, *x = place(key, y);
+		return (x != null ? splay(x) : put(y, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::tuple<>()))->v().second;
+	}
+	const T & operator[](const Key &key) const {return tsearch(key)->v().second;}
 	iterator begin() const {return iter(End->nxt);}
 	const_iterator cbegin() const {return const_iterator(begin());}
 	iterator end() const {return iter(End);}
@@ -269,35 +644,426 @@ public:
 	bool empty() const {return sz == 0;}
 	int size() const {return sz;}
 	pair<iterator, bool> insert(const value_type &value) {
-		Node *x = rt, *y = null;
-		while (x != null) {
-			if (value.first < *x) y = x, x = x->c[0];
-			else if (*x < value.first) y = x, x = x->c[1];
-			else return {iter(splay(x)), 0};
+		Node *y, *x = place(value.first, y);
+		if (x != null) return {iter(splay(x)), 0};
+		return {iter(put(y, value)), 1};
+	}
+	pair<iterator, bool> insert(value_type &&value) {
+		Node *y, *x = place(value.first, y);
+		if (x != null) return {iter(splay(x)), 0};
+		return {iter(put(y, std::move(value))), 1};
+	}
+	/**
+	 * insert value right before hint in amortized O(1) if its key goes there,
+	 * checked against the neighbours of hint; otherwise as insert(value).
+	 * @return the element of the key, new or not.
+	 */
+	iterator insert(iterator hint, const value_type &value) {
+		if (hint.e != End) throw invalid_iterator();
+		if (!fits(hint.x, value.first)) return insert(value).first;
+		return iter(put(gap(hint.x), value));
+	}
+	iterator insert(iterator hint, value_type &&value) {
+		if (hint.e != End) throw invalid_iterator();
+		if (!fits(hint.x, value.first)) return insert(std::move(value)).first;
+		return iter(put(gap(hint.x), std::move(value)));
+	}
+	/**
+	 * construct the value in its node from args, then insert it.
+	 * if the key is taken, the new value is destroyed.
+	 */
+	template <class... Args>
+	pair<iterator, bool> emplace(Args&&... args) {
+		Node *z = M.New(null, std::forward<Args>(args)...);
+		Node *y, *x = place(z->v().first, y);
+		if (x != null) {
+			free_node(z);
+			return {iter(splay(x)), 0};
 		}
-
-		x = M.New(value, null);
-		add(x, y, *y < value.first);
-		return {iter(splay(x)), 1};
+		add(z, y, *y < z->v().first);
+		return {iter(splay(z)), 1};
+	}
+	/**
+	 * insert (k, T(args...)) only if k is absent, the value built in its node;
+	 * args are untouched otherwise.
+	 */
+	template <class... Args>
+	pair<iterator, bool> try_emplace(const Key &k, Args&&... args) {
+		Node *y, *x = place(k, y);
+		if (x != null) return {iter(splay(x)), 0};
+		return {iter(put(y, std::piecewise_construct, std::forward_as_tuple(k), std::forward_as_tuple(std::forward<Args>(args)...))), 1};
+	}
+	template <class... Args>
+	pair<iterator, bool> try_emplace(Key &&k, Args&&... args) {
+		Node *y, *x = place(k, y);
+		if (x != null) return {iter(splay(x)), 0};
+		return {iter(put(y, std::piecewise_construct, std::forward_as_tuple(std::move(k)), std::forward_as_tuple(std::forward<Args>(args)...))), 1};
+	}
+	/**
+	 * insert (k, obj), or assign obj to the value of k if it is present.
+	 * @return true if inserted.
+	 */
+	template <class Obj>
+	pair<iterator, bool> insert_or_assign(const Key &k, Obj &&obj) {
+		Node *y, *x = place(k, y);
+		if (x != null) {
+			x->v().second = std::forward<Obj>(obj);
+			return {iter(splay(x)), 0};
+		}
+		return {iter(put(y, k, std::forward<Obj>(obj))), 1};
+	}
+	template <class Obj>
+	pair<iterator, bool> insert_or_assign(Key &&k, Obj &&obj) {
+		Node *y, *x = place(k, y);
+		if (x != null) {
+			x->v().second = std::forward<Obj>(obj);
+			return {iter(splay(x)), 0};
+		}
+		return {iter(put(y, std::move(k), std::forward<Obj>(obj))), 1};
 	}
 	void erase(iterator pos) {
 		if (End != pos.e || End == pos.x) throw invalid_iterator();
-		Node *x = pos.x;
-		if (x->pre == End) {
-			splay(x->nxt);
-		}
-		else {
-			splay(x->pre);
-			splay(x->nxt, x->pre);
+		del(pos.x);
+	}
+	/**
+	 * erase the element of key if there is one.
+	 * @return the number of elements erased, 0 or 1.
+	 */
+	size_t erase(const Key &key) {
+		Node *y, *x = place(key, y);
+		if (x == null) {
+			splay(y);
+			return 0;
 		}
 		del(x);
+		return 1;
+	}
+	/**
+	 * erase [first, last) in O(logn + k): the elements form one subtree
+	 * between the splayed neighbours, which is cut off whole.
+	 * throw invalid_iterator if an iterator is not of this map or first is after last.
+	 * @return last.
+	 */
+	iterator erase(iterator first, iterator last) {
+		if (first.e != End || last.e != End) throw invalid_iterator();
+		Node *a = first.x, *b = last.x;
+		if (a == b) return last;
+		if (a == End || !(*a < *b)) throw invalid_iterator();
+		Node *p = a->pre;
+		if (p == End) splay(b);
+		else splay(p), splay(b, p);
+		b->c[0] = null;
+		b->pull();
+		if (p != End) p->pull();
+		p->nxt = b, b->pre = p;
+		for (Node *z; a != b; a = z) {
+			z = a->nxt;
+			free_node(a);
+			sz--;
+		}
+		return last;
+	}
+	/**
+	 * erase every element for which pred(element) is true, in O(n), then
+	 * rebuild the tree balanced.
+	 * if pred throws, the elements erased so far stay erased and the rest are kept.
+	 * @return the number of elements erased.
+	 */
+	template <class Pred>
+	size_t erase_if(Pred pred) {
+		int n = sz;
+		try {
+			for (Node *x = End->nxt, *z; x != End; x = z) {
+				z = x->nxt;
+				if (pred(x->v())) del_(x);
+			}
+		}
+		catch (...) {
+			rebalance(); // the tree still has the erased nodes: rebuild it from the list
+			throw;
+		}
+		rebalance();
+		return n - sz;
 	}
-	size_t count(const Key &key) const {return const_cast<map*>(this)->get(key) != End;}
+	size_t count(const Key &key) {return get(key) != End;}
+	size_t count(const Key &key) const {return search(key) != End;}
 	iterator find(const Key &key) {return iter(get(key));}
-	const_iterator find(const Key &key) const {
-		return const_cast<map*>(this)->find(key); // surely const function!
+	const_iterator find(const Key &key) const {return iter(search(key));}
+	template <class K, class C = Compare, class = typename C::is_transparent>
+	size_t count(const K &key) {return get(key) != End;}
+	template <class K, class C = Compare, class = typename C::is_transparent>
+	size_t count(const K &key) const {return search(key) != End;}
+	template <class K, class C = Compare, class = typename C::is_transparent>
+	iterator find(const K &key) {return iter(get(key));}
+	template <class K, class C = Compare, class = typename C::is_transparent>
+	const_iterator find(const K &key) const {return iter(search(key));}
+	/**
+	 * the first element whose key is not less than key, or end().
+	 * [lower_bound(a), lower_bound(b)) walks the keys in [a, b) in O(logn + k).
+	 */
+	iterator lower_bound(const Key &key) {return iter(sbound(key, 0));}
+	const_iterator lower_bound(const Key &key) const {Node *last; return iter(bound(key, 0, last));}
+	/**
+	 * the first element whose key is greater than key, or end().
+	 */
+	iterator upper_bound(const Key &key) {return iter(sbound(key, 1));}
+	const_iterator upper_bound(const Key &key) const {Node *last; return iter(bound(key, 1, last));}
+	template <class K, class C = Compare, class = typename C::is_transparent>
+	iterator lower_bound(const K &key) {return iter(sbound(key, 0));}
+	template <class K, class C = Compare, class = typename C::is_transparent>
+	const_iterator lower_bound(const K &key) const {Node *last; return iter(bound(key, 0, last));}
+	template <class K, class C = Compare, class = typename C::is_transparent>
+	iterator upper_bound(const K &key) {return iter(sbound(key, 1));}
+	template <class K, class C = Compare, class = typename C::is_transparent>
+	const_iterator upper_bound(const K &key) const {Node *last; return iter(bound(key, 1, last));}
+	pair<iterator, iterator> equal_range(const Key &key) {
+		Node *x = sbound(key, 0);
+		return {iter(x), iter(x != End && !(key < *x) ? x->nxt : x)};
+	}
+	pair<const_iterator, const_iterator> equal_range(const Key &key) const {
+		Node *last, *x = bound(key, 0, last);
+		return {iter(x), iter(x != End && !(key < *x) ? x->nxt : x)};
+	}
+	template <class K, class C = Compare, class = typename C::is_transparent>
+	pair<iterator, iterator> equal_range(const K &key) {
+		Node *x = sbound(key, 0);
+		return {iter(x), iter(x != End && !(key < *x) ? x->nxt : x)};
+	}
+	template <class K, class C = Compare, class = typename C::is_transparent>
+	pair<const_iterator, const_iterator> equal_range(const K &key) const {
+		Node *last, *x = bound(key, 0, last);
+		return {iter(x), iter(x != End && !(key < *x) ? x->nxt : x)};
+	}
+	/**
+	 * order statistics, in O(logn) from the subtree sizes kept in the nodes.
+	 * as with the lookups, the non-const ones splay and the const ones do not.
+	 * rank: the number of keys less than key.
+	 */
+	int rank(const Key &key) {Node *last = rt; int ret = less(key, last); splay(last); return ret;}
+	int rank(const Key &key) const {Node *last = rt; return less(key, last);}
+	/**
+	 * the element of index k (from 0) in key order; select(size()) is end().
+	 * throw index_out_of_bound if k is not in [0, size()].
+	 */
+	iterator select(int k) {
+		if (k < 0 || k > sz) throw index_out_of_bound();
+		return iter(splay(kth(k)));
+	}
+	const_iterator select(int k) const {
+		if (k < 0 || k > sz) throw index_out_of_bound();
+		return iter(kth(k));
+	}
+	/**
+	 * it moved n steps, backwards if n < 0.
+	 * throw invalid_iterator if it is not of this map, or the result would be
+	 * out of [begin(), end()].
+	 */
+	iterator advance(iterator it, int n) {
+		if (it.e != End) throw invalid_iterator();
+		int k = splay(it.x)->c[0]->s + n;
+		if (k < 0 || k > sz) throw invalid_iterator();
+		return iter(splay(kth(k)));
+	}
+	const_iterator advance(const_iterator it, int n) const {
+		if (it.x.e != End) throw invalid_iterator();
+		int k = order(it.x.x) + n;
+		if (k < 0 || k > sz) throw invalid_iterator();
+		return iter(kth(k));
+	}
+	/**
+	 * the number of steps from a to b, negative if b is before a.
+	 * throw invalid_iterator if either is not of this map.
+	 */
+	int distance(const_iterator a, const_iterator b) {
+		if (a.x.e != End || b.x.e != End) throw invalid_iterator();
+		int i = splay(a.x.x)->c[0]->s;
+		return splay(b.x.x)->c[0]->s - i;
+	}
+	int distance(const_iterator a, const_iterator b) const {
+		if (a.x.e != End || b.x.e != End) throw invalid_iterator();
+		return order(b.x.x) - order(a.x.x);
+	}
+	/**
+	 * move the elements whose keys are not less than key into a new map,
+	 * in amortized O(logn) by splaying: no element is copied.
+	 * iterators to the moved elements are invalidated.
+	 * the two maps then share one node arena, so they must not be modified
+	 * from different threads at once.
+	 */
+	map split(const Key &key) {
+		map ret;
+		cut(key, 0, ret);
+		return ret;
+	}
+	/**
+	 * move every element of other into this, in amortized O(logn), leaving
+	 * other empty. the keys of other must all be less, or all be greater,
+	 * than those of this; throw runtime_error otherwise, with both unchanged.
+	 * iterators into other are invalidated, and the maps share a node arena
+	 * as after split.
+	 */
+	void join(map &&other) {
+		if (this == &other || !other.sz) return;
+		Node *a = other.End->nxt, *b = other.End->pre; // the first and the last of other
+		bool after = !sz || *End->pre < a->v().first;
+		if (!after && !(*b < End->nxt->v().first)) throw runtime_error();
+		settle(), other.settle();
+		M.absorb(other.M);
+		other.splay(other.End);
+		Node *t = other.End->c[0];
+		splay(End);
+		if (sz) { // t hangs off the neighbour of other in this, next to End
+			Node *p = after ? End->pre : End->nxt;
+			splay(p, End);
+			p->setc(t, after);
+			p->pull();
+		}
+		else End->setc(t, 0);
+		End->pull();
+		if (after) {
+			Node *p = End->pre;
+			p->nxt = a, a->pre = p;
+			b->nxt = End, End->pre = b;
+		}
+		else {
+			Node *f = End->nxt;
+			End->nxt = a, a->pre = End;
+			b->nxt = f, f->pre = b;
+		}
+		sz += other.sz;
+		other.reset();
+	}
+	/**
+	 * set operations with other, in O(n + m) by a merge of the two lists and
+	 * a rebuild of the part of this within the key range of other; what is
+	 * outside that range is split off and joined back in O(logn).
+	 * merge moves the elements of other whose keys are absent here into this,
+	 * no element copied; the rest stay in other, as with std::map::merge.
+	 * should Compare, combine or a copy throw, the work done so far is kept
+	 * and no element is lost.
+	 */
+	void merge(map &&other) {
+		if (this == &other || !other.sz) return;
+		if (apart(other)) {
+			join(std::move(other));
+			return;
+		}
+		map m, r;
+		isolate(other, m, r);
+		other.settle();
+		m.M.absorb(other.M);
+		Node *x = m.End->nxt, *y = other.End->nxt;
+		try {
+			while (y != other.End) {
+				if (*x < y->v().first) x = x->nxt;
+				else {
+					Node *z = y->nxt;
+					if (y->v().first < *x) other.unlink(y), m.link(y, x);
+					y = z;
+				}
+			}
+		}
+		catch (...) { // Compare threw: what is moved stays moved, and both trees are rebuilt
+			other.rebalance();
+			rejoin(m, r);
+			throw;
+		}
+		other.rebalance();
+		rejoin(m, r);
+	}
+	/**
+	 * add a copy of every element of other whose key is absent here; where
+	 * the key is present, the value becomes combine(value here, value in other).
+	 */
+	template <class Combine>
+	void union_with(const map &other, Combine combine) {
+		if (this == &other) {
+			union_with(map(other), combine);
+			return;
+		}
+		if (!other.sz) return;
+		if (apart(other)) {
+			join(map(other));
+			return;
+		}
+		map m, r;
+		isolate(other, m, r);
+		Node *x = m.End->nxt, *y = other.End->nxt;
+		try {
+			while (y != other.End) {
+				if (*x < y->v().first) x = x->nxt;
+				else {
+					if (y->v().first < *x) m.link(m.M.New(null, y->v()), x);
+					else x->v().second = combine(x->v().second, y->v().second);
+					y = y->nxt;
+				}
+			}
+		}
+		catch (...) { // combine or a copy threw: keep what is done so far
+			rejoin(m, r);
+			throw;
+		}
+		rejoin(m, r);
+	}
+	/**
+	 * keep only the elements whose keys are in other.
+	 */
+	void intersect(const map &other) {
+		if (this == &other) return;
+		if (apart(other)) {
+			clear();
+			return;
+		}
+		map m, r;
+		isolate(other, m, r);
+		clear();
+		r.clear();
+		Node *x = m.End->nxt, *y = other.End->nxt;
+		try {
+			while (x != m.End) {
+				Node *z = x->nxt;
+				while (*y < x->v().first) y = y->nxt;
+				if (x->v().first < *y) m.del_(x);
+				x = z;
+			}
+		}
+		catch (...) {
+			rejoin(m, r);
+			throw;
+		}
+		rejoin(m, r);
+	}
+	/**
+	 * remove the elements whose keys are in other.
+	 */
+	void difference(const map &other) {
+		if (this == &other) {
+			clear();
+			return;
+		}
+		if (apart(other)) return;
+		map m, r;
+		isolate(other, m, r);
+		Node *x = m.End->nxt, *y = other.End->nxt;
+		try {
+			while (x != m.End) {
+				Node *z = x->nxt;
+				while (*y < x->v().first) y = y->nxt;
+				if (!(x->v().first < *y)) m.del_(x);
+				x = z;
+			}
+		}
+		catch (...) {
+			rejoin(m, r);
+			throw;
+		}
+		rejoin(m, r);
 	}
 };
+
+template<class Key, class T, class Compare>
+typename map<Key, T, Compare>::Node map<Key, T, Compare>::nil; // only its size, 0 from zero-initialization, is ever read
+
 }
 
 #endif
@@ -0,0 +1,353 @@
+/**
+ * an open addressing hash map with the interface of sjtu::map, unordered
+ */
+
+#ifndef SJTU_UNORDERED_MAP_HPP
+#define SJTU_UNORDERED_MAP_HPP
+
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+/**
+ * a swiss table: every slot has a control byte, either empty, deleted, or
+ * 7 bits of the hash of its key. a lookup reads the control bytes 16 at a
+ * time and compares them with the 7 bits of its own hash all at once (one
+ * sse2 instruction), so keys are only compared on a near sure match, and
+ * it stops at the first group of 16 that has an empty slot.
+ * it grows at 7/8 full. an insert may rehash and invalidate every iterator;
+ * an erase invalidates only its own.
+ */
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class KeyEqual = std::equal_to<Key>
+> class unordered_map {
+
+public:
+	class const_iterator;
+	class iterator;
+	typedef sjtu::pair<const Key, T> value_type;
+
+private:
+	typedef typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type slot;
+
+	// full slots hold 0..127; the sentinel ends the table for iteration
+	enum : int8_t {Empty = -128, Deleted = -2, Sentinel = -1};
+	enum {W = 16}; // the group width
+
+#ifdef __SSE2__
+	struct group {
+		__m128i g;
+		explicit group(const int8_t *p) : g(_mm_loadu_si128((const __m128i *)p)) {}
+		unsigned match(int8_t h) const {return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h), g));}
+		unsigned empty() const {return match(Empty);}
+		unsigned free() const {return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(Sentinel), g));} // empty or deleted
+	};
+#else
+	struct group {
+		const int8_t *p;
+		explicit group(const int8_t *q) : p(q) {}
+		unsigned match(int8_t h) const {
+			unsigned r = 0;
+			for (int i = 0; i < W; i++) r |= (unsigned)(p[i] == h) << i;
+			return r;
+		}
+		unsigned empty() const {return match(Empty);}
+		unsigned free() const {
+			unsigned r = 0;
+			for (int i = 0; i < W; i++) r |= (unsigned)(p[i] < Sentinel) << i;
+			return r;
+		}
+	};
+#endif
+
+	// the table has cap = 2^k - 1 slots, cap at least W - 1 or 0. ctrl[cap] is
+	// the sentinel and the W - 1 bytes after it copy ctrl[0, W - 1), so a
+	// group may start at any slot without wrapping around
+	int8_t *ctrl; slot *slots;
+	size_t cap, left; // left: inserts into empty slots before it grows
+	int sz;
+	Hash hasher;
+	KeyEqual eq;
+
+	static int8_t *empty_ctrl() { // an empty table without allocating: ctrl[0] is the sentinel
+		static const int8_t e[W] = {Sentinel, Empty, Empty, Empty, Empty, Empty, Empty, Empty,
+			Empty, Empty, Empty, Empty, Empty, Empty, Empty, Empty};
+		return const_cast<int8_t *>(e);
+	}
+
+	static size_t growth(size_t c) {return c - c / 8;}
+
+	size_t hash(const Key &k) const {return mix_hash(hasher(k));}
+
+	value_type & V(size_t i) const {return *(value_type *)&slots[i];}
+
+	void set(size_t i, int8_t h) {
+		ctrl[i] = h;
+		ctrl[((i - (W - 1)) & cap) + (W - 1)] = h;
+	}
+
+	/**
+	 * groups are visited at triangular offsets from the hash, which reaches
+	 * every group when the number of slots + 1 is a power of 2.
+	 */
+	size_t find_(const Key &k, size_t h) const { // the slot of k, or cap
+		int8_t h2 = h & 127;
+		for (size_t p = (h >> 7) & cap, step = 0;; step += W, p = (p + step) & cap) {
+			group g(ctrl + p);
+			for (unsigned m = g.match(h2); m; m &= m - 1) {
+				size_t i = (p + __builtin_ctz(m)) & cap;
+				if (eq(V(i).first, k)) return i;
+			}
+			if (g.empty()) return cap;
+		}
+	}
+
+	size_t free_slot(size_t h) const { // the first empty or deleted slot on the probe of h
+		for (size_t p = (h >> 7) & cap, step = 0;; step += W, p = (p + step) & cap) {
+			unsigned m = group(ctrl + p).free();
+			if (m) return (p + __builtin_ctz(m)) & cap;
+		}
+	}
+
+	size_t prepare(size_t h) { // a slot for a new key of hash h, rehashing if it is time
+		size_t i = free_slot(h);
+		if (!left && ctrl[i] != Deleted) {
+			// when at least half of it is deleted, rehash to the same size
+			rehash(cap && (size_t)sz <= cap / 2 ? cap : cap * 2 + 1);
+			i = free_slot(h);
+		}
+		if (ctrl[i] == Empty) left--;
+		set(i, h & 127);
+		sz++;
+		return i;
+	}
+
+	void rehash(size_t c) { // to c slots, c = 2^k - 1
+		if (c < W - 1) c = W - 1;
+		int8_t *oc = ctrl; slot *os = slots;
+		size_t ocap = cap;
+		ctrl = new int8_t[c + W];
+		slots = new slot[c];
+		cap = c;
+		for (size_t i = 0; i < c + W; i++) ctrl[i] = Empty;
+		ctrl[c] = Sentinel;
+		left = growth(c) - sz;
+		for (size_t i = 0; i < ocap; i++) if (oc[i] >= 0) {
+			value_type &v = *(value_type *)&os[i];
+			size_t h = hash(v.first), j = free_slot(h);
+			set(j, h & 127);
+			new(&slots[j]) value_type(std::move(v));
+			v.~value_type();
+		}
+		if (ocap) {
+			delete [] oc;
+			delete [] os;
+		}
+	}
+
+	void erase_(size_t i) {
+		V(i).~value_type();
+		sz--;
+		// a probe passes i only if the group around it was ever full; if not, i can be empty again
+		unsigned after = group(ctrl + i).empty(), before = group(ctrl + ((i - W) & cap)).empty();
+		if (after && before && __builtin_ctz(after) + __builtin_clz(before << (32 - W)) < W) {
+			set(i, Empty);
+			left++;
+		}
+		else set(i, Deleted);
+	}
+
+	void free_all() {
+		if (!cap) return;
+		if (!std::is_trivially_destructible<value_type>::value)
+			for (size_t i = 0; i < cap; i++) if (ctrl[i] >= 0) V(i).~value_type();
+		delete [] ctrl;
+		delete [] slots;
+	}
+
+	void copy(const unordered_map &other) { // into an empty map, slot for slot
+		if (!other.sz) return;
+		cap = other.cap, left = other.left, sz = other.sz;
+		ctrl = new int8_t[cap + W];
+		slots = new slot[cap];
+		for (size_t i = 0; i < cap + W; i++) ctrl[i] = other.ctrl[i];
+		for (size_t i = 0; i < cap; i++) if (ctrl[i] >= 0) new(&slots[i]) value_type(other.V(i));
+	}
+
+	size_t skip(size_t i) const { // the first full slot from i, or cap at the sentinel
+		while (ctrl[i] < Sentinel) i++;
+		return i;
+	}
+
+public:
+	class iterator {
+		friend unordered_map;
+	private:
+		const unordered_map *m; size_t i;
+	public:
+		iterator() {}
+		iterator(const unordered_map *y, size_t j) : m(y), i(j) {}
+		iterator(const iterator &other) : m(other.m), i(other.i) {}
+		iterator & operator++() {
+			if (i == m->cap) throw invalid_iterator();
+			i = m->skip(i + 1);
+			return *this;
+		}
+		iterator operator++(int) {
+			iterator ret = *this;
+			++(*this);
+			return ret;
+		}
+		value_type & operator*() const {if (i == m->cap) throw invalid_iterator(); return m->V(i);}
+		value_type* operator->() const noexcept {return &m->V(i);}
+		bool operator==(const iterator &rhs) const {return i == rhs.i && m == rhs.m;}
+		bool operator!=(const iterator &rhs) const {return !(*this == rhs);}
+	};
+
+	class const_iterator {
+		private:
+			iterator x;
+		public:
+			const_iterator() {}
+			const_iterator(const iterator &other) : x(other) {}
+			const_iterator(const const_iterator &other) : x(other.x) {}
+			const_iterator & operator ++ ()  {++x; return *this;}
+			const_iterator operator ++ (int) {const_iterator ret(*this); ++x; return ret;}
+			const value_type & operator*() const {return *x;}
+			const value_type* operator->() const noexcept {return &(*x);}
+			bool operator==(const const_iterator &rhs) const {return x == rhs.x;}
+			bool operator!=(const const_iterator &rhs) const {return x != rhs.x;}
+			friend bool operator==(const const_iterator &lhs, const iterator &rhs) {return lhs.x == rhs;}
+			friend bool operator==(const iterator &lhs, const const_iterator &rhs) {return lhs == rhs.x;}
+			friend bool operator!=(const const_iterator &lhs, const iterator &rhs) {return lhs.x != rhs;}
+			friend bool operator!=(const iterator &lhs, const const_iterator &rhs) {return lhs != rhs.x;}
+	};
+
+	inline iterator iter(size_t i) const {
+		return iterator(this, i);
+	}
+	inline void shared_construct() {
+		ctrl = empty_ctrl();
+		slots = NULL;
+		cap = left = 0;
+		sz = 0;
+	}
+	void clear() {
+		free_all();
+		shared_construct();
+	}
+	unordered_map() {
+		shared_construct();
+	}
+	explicit unordered_map(size_t n, const Hash &h = Hash(), const KeyEqual &e = KeyEqual()) : hasher(h), eq(e) {
+		shared_construct();
+		reserve(n);
+	}
+	unordered_map(const unordered_map &other) : hasher(other.hasher), eq(other.eq) {
+		shared_construct();
+		copy(other);
+	}
+	unordered_map & operator=(const unordered_map &other) {
+		if (this != &other) {
+			clear();
+			hasher = other.hasher, eq = other.eq;
+			copy(other);
+		}
+		return *this;
+	}
+	~unordered_map() {
+		free_all();
+	}
+	/**
+	 * make room for n elements in all, so that inserting up to n never rehashes.
+	 */
+	void reserve(size_t n) {
+		size_t c = W - 1;
+		while (growth(c) < n) c = c * 2 + 1;
+		if (c > cap) rehash(c);
+	}
+	T & at(const Key &key) {
+		size_t i = find_(key, hash(key));
+		if (i == cap) throw index_out_of_bound();
+		return V(i).second;
+	}
+	const T & at(const Key &key) const {
+		size_t i = find_(key, hash(key));
+		if (i == cap) throw index_out_of_bound();
+		return V(i).second;
+	}
+	T & operator[](const Key &key) {return try_emplace(key).first->second;}
+	const T & operator[](const Key &key) const {return at(key);}
+	iterator begin() const {return iter(skip(0));}
+	const_iterator cbegin() const {return const_iterator(begin());}
+	iterator end() const {return iter(cap);}
+	const_iterator cend() const {return const_iterator(end());}
+	bool empty() const {return sz == 0;}
+	int size() const {return sz;}
+	pair<iterator, bool> insert(const value_type &value) {
+		size_t h = hash(value.first), i = find_(value.first, h);
+		if (i != cap) return {iter(i), 0};
+		i = prepare(h);
+		new(&slots[i]) value_type(value);
+		return {iter(i), 1};
+	}
+	pair<iterator, bool> insert(value_type &&value) {
+		size_t h = hash(value.first), i = find_(value.first, h);
+		if (i != cap) return {iter(i), 0};
+		i = prepare(h);
+		new(&slots[i]) value_type(std::move(value));
+		return {iter(i), 1};
+	}
+	/**
+	 * insert (k, T(args...)) only if k is absent; args are untouched otherwise.
+	 */
+	template <class... Args>
+	pair<iterator, bool> try_emplace(const Key &k, Args&&... args) {
+		size_t h = hash(k), i = find_(k, h);
+		if (i != cap) return {iter(i), 0};
+		i = prepare(h);
+		new(&slots[i]) value_type(k, T(std::forward<Args>(args)...));
+		return {iter(i), 1};
+	}
+	template <class... Args>
+	pair<iterator, bool> try_emplace(Key &&k, Args&&... args) {
+		size_t h = hash(k), i = find_(k, h);
+		if (i != cap) return {iter(i), 0};
+		i = prepare(h);
+		new(&slots[i]) value_type(std::move(k), T(std::forward<Args>(args)...));
+		return {iter(i), 1};
+	}
+	void erase(iterator pos) {
+		if (pos.m != this || pos.i >= cap || ctrl[pos.i] < 0) throw invalid_iterator();
+		erase_(pos.i);
+	}
+	/**
+	 * erase the element of key if there is one.
+	 * @return the number of elements erased, 0 or 1.
+	 */
+	size_t erase(const Key &key) {
+		size_t i = find_(key, hash(key));
+		if (i == cap) return 0;
+		erase_(i);
+		return 1;
+	}
+	size_t count(const Key &key) const {return find_(key, hash(key)) != cap;}
+	iterator find(const Key &key) {return iter(find_(key, hash(key)));}
+	const_iterator find(const Key &key) const {return iter(find_(key, hash(key)));}
+};
+}
+
+#endif
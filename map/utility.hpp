@@ -1,10 +1,22 @@
 #ifndef SJTU_UTILITY_HPP
 #define SJTU_UTILITY_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
 #include <utility>
 
 namespace sjtu {
 
+/**
+ * spread the bits of a hash code before it picks a bucket, for std::hash
+ * of an integer is the integer itself; shared by the hash maps.
+ */
+inline size_t mix_hash(size_t h) {
+	uint64_t x = (uint64_t)h * 0x9e3779b97f4a7c15ull;
+	return (size_t)(x ^ x >> 32);
+}
+
 template<class T1, class T2>
 class pair {
 public:
@@ -15,12 +27,23 @@ public:
 	pair(pair &&other) = default;
 	pair(const T1 &x, const T2 &y) : first(x), second(y) {}
 	template<class U1, class U2>
-	pair(U1 &&x, U2 &&y) : first(x), second(y) {}
+	pair(U1 &&x, U2 &&y) : first(std::forward<U1>(x)), second(std::forward<U2>(y)) {}
 	template<class U1, class U2>
 	pair(const pair<U1, U2> &other) : first(other.first), second(other.second) {
 	}
 	template<class U1, class U2>
-	pair(pair<U1, U2> &&other) : first(other.first), second(other.second) {}
+	pair(pair<U1, U2> &&other) : first(std::move(other.first)), second(std::move(other.second)) {}
+	/**
+	 * as std::pair: first and second each built in place from a tuple of arguments.
+	 */
+	template<class... Args1, class... Args2>
+	pair(std::piecewise_construct_t, std::tuple<Args1...> x, std::tuple<Args2...> y)
+		: pair(x, y, std::index_sequence_for<Args1...>(), std::index_sequence_for<Args2...>()) {}
+private:
+	template<class A, class B, size_t... I, size_t... J>
+	pair(A &x, B &y, std::index_sequence<I...>, std::index_sequence<J...>)
+		: first(std::forward<typename std::tuple_element<I, A>::type>(std::get<I>(x))...),
+		  second(std::forward<typename std::tuple_element<J, B>::type>(std::get<J>(y))...) {}
 };
 
 }
@@ -0,0 +1,76 @@
+#ifndef SJTU_BOUNDED_PRIORITY_QUEUE_HPP
+#define SJTU_BOUNDED_PRIORITY_QUEUE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include "priority_queue.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+/**
+ * keep only the k elements that a priority_queue<T, Compare> would pop first.
+ * the kept elements are held in a heap whose top is the worst of them, so a
+ * new element is rejected with one comparison and no allocation, and an
+ * accepted one replaces the worst in O(logk).
+ */
+template<typename T, class Compare = std::less<T>>
+class bounded_priority_queue {
+private:
+	struct reversed {
+		Compare c;
+		bool operator()(const T &a, const T &b) {return c(b, a);}
+	};
+
+	priority_queue<T, reversed> q;
+	size_t k;
+	Compare cmp;
+
+	template <class U>
+	bool add(U &&e) {
+		if (q.size() < k) {q.push(std::forward<U>(e)); return true;}
+		if (!k || !cmp(q.top(), e)) return false;
+		q.replace_top(std::forward<U>(e));
+		return true;
+	}
+
+public:
+	explicit bounded_priority_queue(size_t capacity, const Compare &c = Compare())
+		: q(reversed{c}), k(capacity), cmp(c) {}
+	/**
+	 * offer e to the queue.
+	 * @return true if e is kept, false if it is rejected.
+	 */
+	bool push(const T &e) {return add(e);}
+	bool push(T &&e) {return add(std::move(e));}
+	/**
+	 * the worst element kept, i.e. the bar a new element has to beat.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	const T & worst() const {
+		return q.top();
+	}
+	/**
+	 * move every element to out in sorted order (ascending by Compare, so the
+	 * best comes last, as std::sort would put it), leaving the queue empty.
+	 */
+	template <class OutputIterator>
+	OutputIterator drain(OutputIterator out) {
+		while (!q.empty()) *out++ = q.pop_value();
+		return out;
+	}
+	size_t capacity() const {
+		return k;
+	}
+	size_t size() const {
+		return q.size();
+	}
+	bool empty() const {
+		return q.empty();
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <set>
+#include <vector>
+#include <cstdio>
+#include <functional>
+
+#include "minmax_heap.hpp"
+
+int last = 23333;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+template <class Q>
+bool same(const Q &q, const std::multiset<int> &s) {
+	if (q.size() != s.size()) return false;
+	return s.empty() || (q.top_min() == *s.begin() && q.top_max() == *s.rbegin());
+}
+
+void TestBothEnds()
+{
+	std::cout << "Testing pop_min and pop_max..." << std::endl;
+	sjtu::minmax_heap<int> q;
+	std::multiset<int> s;
+	bool ok = true;
+	for (int i = 0; i < 200000; ++i) {
+		int op = Rand() % 7;
+		if (op < 4 || s.empty()) {
+			int x = Rand() % 1000; // many equal elements
+			q.push(x), s.insert(x);
+		}
+		else if (op == 4) q.pop_min(), s.erase(s.begin());
+		else q.pop_max(), s.erase(--s.end());
+		if (!same(q, s)) ok = false;
+	}
+	std::cout << q.size() << std::endl;
+	sjtu::minmax_heap<int> c(q);
+	while (!s.empty()) {
+		if (s.size() & 1) c.pop_min(), s.erase(s.begin());
+		else c.pop_max(), s.erase(--s.end());
+		if (!same(c, s)) ok = false;
+	}
+	std::cout << (ok && c.empty() ? "OK" : "WA") << std::endl;
+	try {c.pop_min(); std::cout << "WA" << std::endl;} catch (sjtu::container_is_empty) {}
+	try {c.pop_max(); std::cout << "WA" << std::endl;} catch (sjtu::container_is_empty) {}
+	try {c.top_max(); std::cout << "WA" << std::endl;} catch (sjtu::container_is_empty) {}
+	c = q;
+	std::cout << c.size() << " " << c.top_min() << " " << c.top_max() << std::endl;
+	sjtu::minmax_heap<int, std::greater<int>> g;
+	for (int i = 1; i <= 3; ++i) {
+		g.push(i);
+		std::cout << g.top_min() << g.top_max() << " ";
+	}
+	std::cout << std::endl;
+}
+
+void TestMerge()
+{
+	std::cout << "Testing merge..." << std::endl;
+	bool ok = true;
+	// a small other is pushed in one by one, a big one is concatenated and rebuilt
+	int sizes[][2] = {{10000, 5}, {10000, 3000}, {5, 10000}, {0, 100}, {100, 0}, {1, 1}};
+	for (auto &n : sizes) {
+		sjtu::minmax_heap<int> a, b;
+		std::multiset<int> s;
+		for (int i = 0; i < n[0]; ++i) {int x = Rand() % 5000; a.push(x), s.insert(x);}
+		for (int i = 0; i < n[1]; ++i) {int x = Rand() % 5000; b.push(x), s.insert(x);}
+		a.merge(b);
+		a.merge(a);
+		if (!b.empty() || !same(a, s)) ok = false;
+		b.push(-1), b.pop_max();
+		for (int i = 0; !s.empty(); ++i) {
+			if (i & 1) a.pop_min(), s.erase(s.begin());
+			else a.pop_max(), s.erase(--s.end());
+			if (!same(a, s)) ok = false;
+		}
+		std::cout << n[0] + n[1] << " ";
+	}
+	std::cout << std::endl;
+	std::cout << (ok ? "OK" : "WA") << std::endl;
+}
+
+int main()
+{
+	TestBothEnds();
+	TestMerge();
+	return 0;
+}
@@ -0,0 +1,75 @@
+#include <iostream>
+#include <vector>
+#include <set>
+#include <cstdio>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+#include "bounded_priority_queue.hpp"
+
+int last = 31415;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+template <class Compare>
+bool Check(size_t k, int n, int span)
+{
+	sjtu::bounded_priority_queue<int, Compare> q(k);
+	std::multiset<int, Compare> kept; // by hand: a new element must beat the worst kept one
+	std::vector<int> all;
+	bool ok = q.capacity() == k;
+	for (int i = 0; i < n; ++i) {
+		int x = Rand() % span;
+		all.push_back(x);
+		bool expect = kept.size() < k || (k && Compare()(*kept.begin(), x));
+		if (expect) {
+			if (kept.size() == k) kept.erase(kept.begin());
+			kept.insert(x);
+		}
+		if (q.push(x) != expect || q.size() != kept.size()) ok = false;
+		if (!kept.empty() && q.worst() != *kept.begin()) ok = false;
+	}
+	// sort, keep the top k: the last k in ascending order of Compare
+	std::sort(all.begin(), all.end(), Compare());
+	std::vector<int> top(all.end() - std::min<size_t>(k, all.size()), all.end()), got;
+	q.drain(std::back_inserter(got));
+	return ok && got == top && q.empty();
+}
+
+void TestTopK()
+{
+	std::cout << "Testing top k..." << std::endl;
+	size_t ks[] = {0, 1, 7, 100, 1000, 5000};
+	for (auto k : ks) {
+		bool a = Check<std::less<int>>(k, 2000, 1000000);
+		bool b = Check<std::greater<int>>(k, 2000, 1000000);
+		bool c = Check<std::less<int>>(k, 2000, 50); // many equal elements
+		std::cout << k << " " << (a && b && c ? "OK" : "WA") << std::endl;
+	}
+}
+
+void TestSmall()
+{
+	std::cout << "Testing by hand..." << std::endl;
+	sjtu::bounded_priority_queue<int> q(3);
+	int a[] = {5, 1, 9, 5, 3, 9, 7, 5};
+	for (auto x : a) std::cout << q.push(x);
+	std::cout << " " << q.worst() << std::endl;
+	int b[3];
+	q.drain(b);
+	std::cout << b[0] << " " << b[1] << " " << b[2] << std::endl;
+	try {q.worst(); std::cout << "WA" << std::endl;} catch (sjtu::container_is_empty) {}
+	sjtu::bounded_priority_queue<int> none(0);
+	std::cout << none.push(1) << none.size() << std::endl;
+	try {none.worst(); std::cout << "WA" << std::endl;} catch (sjtu::container_is_empty) {}
+}
+
+int main()
+{
+	TestTopK();
+	TestSmall();
+	return 0;
+}
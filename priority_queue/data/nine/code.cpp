@@ -0,0 +1,182 @@
+#include <iostream>
+#include <queue>
+#include <vector>
+#include <cstdio>
+#include <string>
+#include <memory>
+
+#include "priority_queue.hpp"
+
+int last = 1234;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+long long calls;
+
+struct CountLess { // std::less on strings, counting the calls
+	bool operator()(const std::string &a, const std::string &b) const {
+		calls++;
+		return a < b;
+	}
+};
+
+struct Prefix { // the first two chars; agrees with CountLess: a smaller prefix is a smaller string
+	int operator()(const std::string &s) const {
+		int k = 0;
+		for (size_t i = 0; i < 2; ++i) k = k * 257 + (i < s.size() ? (unsigned char)s[i] + 1 : 0);
+		return k;
+	}
+};
+
+struct ModLess { // by x % m, then by x; it has no default constructor
+	int m;
+	explicit ModLess(int m) : m(m) {}
+	bool operator()(int a, int b) const {return a % m < b % m || (a % m == b % m && a < b);}
+};
+
+int copies;
+
+struct Item { // a key and a payload, counting the copies
+	int k; std::string s;
+	Item(int k, const std::string &s) : k(k), s(s) {}
+	Item(const Item &b) : k(b.k), s(b.s) {copies++;}
+	Item(Item &&b) = default;
+	Item &operator=(const Item &b) {k = b.k, s = b.s, copies++; return *this;}
+	Item &operator=(Item &&b) = default;
+	bool operator<(const Item &b) const {return k < b.k;}
+};
+
+struct PtrLess {
+	bool operator()(const std::unique_ptr<int> &a, const std::unique_ptr<int> &b) const {return *a < *b;}
+};
+
+std::string RandString() {
+	std::string s;
+	for (int i = Rand() % 6; i >= 0; --i) s += char('a' + Rand() % 26);
+	return s;
+}
+
+void TestProjection()
+{
+	std::cout << "Testing projection..." << std::endl;
+	std::vector<std::string> a;
+	for (int i = 0; i < 100000; ++i) a.push_back(RandString());
+	sjtu::priority_queue<std::string, CountLess> plain;
+	sjtu::priority_queue<std::string, CountLess, Prefix> keyed;
+	std::priority_queue<std::string> std_pq;
+	bool ok = true;
+	long long plain_calls = 0, keyed_calls = 0;
+	for (int round = 0; round < 2; ++round) {
+		// round 0 pushes one by one, round 1 builds from the range
+		calls = 0;
+		if (round == 0) for (auto &s : a) plain.push(s);
+		else plain.push_range(a.begin(), a.end());
+		for (int i = 0; i < 50000; ++i) plain.pop();
+		plain_calls += calls;
+		calls = 0;
+		if (round == 0) for (auto &s : a) keyed.push(s);
+		else keyed.push_range(a.begin(), a.end());
+		for (int i = 0; i < 50000; ++i) keyed.pop();
+		keyed_calls += calls;
+		for (auto &s : a) std_pq.push(s);
+		for (int i = 0; i < 50000; ++i) std_pq.pop();
+		if (plain.top() != std_pq.top() || keyed.top() != std_pq.top()) ok = false;
+	}
+	sjtu::priority_queue<std::string, CountLess, Prefix> copy(keyed), assigned;
+	assigned = keyed;
+	for (int i = 0; i < 20000; ++i) {
+		std::string s = RandString();
+		copy.push(s), std_pq.push(s);
+		copy.replace_top(copy.top() + "z");
+		std::string t = std_pq.top() + "z";
+		std_pq.pop(), std_pq.push(t);
+		if (copy.top() != std_pq.top()) ok = false;
+	}
+	std::cout << copy.size() << " " << assigned.size() << std::endl;
+	while (!std_pq.empty()) {
+		if (copy.top() != std_pq.top()) ok = false;
+		copy.pop(), std_pq.pop();
+	}
+	std::cout << (ok && copy.empty() ? "OK" : "WA") << std::endl;
+	// the keys are unequal for most pairs, so most compares never call CountLess
+	std::cout << (keyed_calls * 4 < plain_calls ? "OK" : "WA") << std::endl;
+}
+
+void TestStatefulCompare()
+{
+	std::cout << "Testing stateful comparator..." << std::endl;
+	sjtu::priority_queue<int, ModLess> pq(ModLess(100));
+	std::priority_queue<int, std::vector<int>, ModLess> std_pq(ModLess(100));
+	bool ok = true;
+	for (int i = 0; i < 100000; ++i) {
+		if (Rand() % 3 || std_pq.empty()) {
+			int x = Rand();
+			pq.push(x), std_pq.push(x);
+		}
+		else pq.pop(), std_pq.pop();
+		if (pq.size() != std_pq.size() || (!pq.empty() && pq.top() != std_pq.top())) ok = false;
+	}
+	std::cout << (ok ? "OK" : "WA") << std::endl;
+	int b[] = {105, 7, 299, 42, 1000};
+	sjtu::priority_queue<int, ModLess> small(b, b + 5, ModLess(10)), other(ModLess(1000));
+	other = small; // the comparator is copied as well
+	sjtu::priority_queue<int, ModLess> copy(other);
+	copy.push(58);
+	copy.merge(small);
+	while (!copy.empty()) {
+		std::cout << copy.top() << " ";
+		copy.pop();
+	}
+	std::cout << std::endl;
+}
+
+void TestEmplace()
+{
+	std::cout << "Testing emplace and pop_value..." << std::endl;
+	sjtu::priority_queue<Item> pq;
+	std::priority_queue<int> std_pq;
+	bool ok = true;
+	for (int i = 0; i < 50000; ++i) {
+		int x = Rand();
+		if (i & 1) pq.emplace(x, std::to_string(x));
+		else pq.push(Item(x, std::to_string(x)));
+		std_pq.push(x);
+		if (Rand() % 3 == 0) {
+			Item t = pq.pop_value();
+			if (t.k != std_pq.top() || t.s != std::to_string(t.k)) ok = false;
+			std_pq.pop();
+		}
+	}
+	std::cout << pq.size() << " " << copies << std::endl;
+	Item t(-1, "");
+	pq.replace_top(std::move(t));
+	std_pq.pop(), std_pq.push(-1);
+	while (!pq.empty()) {
+		if (pq.pop_value().k != std_pq.top()) ok = false;
+		std_pq.pop();
+	}
+	std::cout << (ok ? "OK" : "WA") << " " << copies << std::endl;
+	try {pq.pop_value(); std::cout << "WA" << std::endl;} catch (sjtu::container_is_empty) {}
+	// a type that can only be moved
+	sjtu::priority_queue<std::unique_ptr<int>, PtrLess> up;
+	int b[] = {3, 1, 4, 1, 5, 9, 2, 6};
+	for (int i = 0; i < 8; ++i) {
+		if (i & 1) up.emplace(new int(b[i]));
+		else up.push(std::unique_ptr<int>(new int(b[i])));
+	}
+	while (!up.empty()) {
+		std::unique_ptr<int> p = up.pop_value();
+		std::cout << *p << " ";
+	}
+	std::cout << std::endl;
+}
+
+int main()
+{
+	TestProjection();
+	TestStatefulCompare();
+	TestEmplace();
+	return 0;
+}
@@ -0,0 +1,90 @@
+#include <iostream>
+#include <queue>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+#include <string>
+
+#include "persistent_priority_queue.hpp"
+
+int last = 2333;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+template <class Q, class StdQ>
+bool same(Q q, StdQ std_q) { // both taken by value: the copies are popped, not the versions
+	if (q.size() != std_q.size()) return false;
+	while (!std_q.empty()) {
+		if (q.top() != std_q.top()) return false;
+		q.pop(), std_q.pop();
+	}
+	return q.empty();
+}
+
+void TestVersions()
+{
+	std::cout << "Testing old versions..." << std::endl;
+	std::vector<sjtu::persistent_priority_queue<int>> pq(1);
+	std::vector<std::priority_queue<int>> std_pq(1);
+	bool ok = true;
+	for (int i = 0; i < 3000; ++i) {
+		// a new version from one of the last few, so versions branch but still grow
+		int v = pq.size() - 1 - Rand() % std::min<int>(pq.size(), 8), op = Rand() % 4;
+		pq.push_back(pq[v]);
+		std_pq.push_back(std_pq[v]);
+		int w = Rand() % pq.size(); // any old version
+		if (op == 3 && pq.back().size() + pq[w].size() > 2000) op = 0; // keep the sizes bounded
+		if (op < 2 || pq.back().empty()) {
+			int x = Rand();
+			pq.back().push(x), std_pq.back().push(x);
+		}
+		else if (op == 2) pq.back().pop(), std_pq.back().pop();
+		else {
+			pq.back().merge(pq[w]);
+			for (auto t = std_pq[w]; !t.empty(); t.pop()) std_pq.back().push(t.top());
+		}
+		if (pq.back().size() != std_pq.back().size() || (!pq.back().empty() && pq.back().top() != std_pq.back().top())) ok = false;
+	}
+	std::cout << (ok ? "OK" : "WA") << std::endl;
+	for (size_t i = 0; i < pq.size(); ++i)
+		if (!same(pq[i], std_pq[i])) ok = false;
+	std::cout << pq.back().size() << std::endl;
+	std::cout << (ok ? "OK" : "WA") << std::endl;
+}
+
+void TestCopyAndAssign()
+{
+	std::cout << "Testing copy and assignment..." << std::endl;
+	sjtu::persistent_priority_queue<std::string, std::greater<std::string>> a;
+	for (int i = 0; i < 10; ++i) a.push(std::to_string(i * 7 % 10));
+	auto b = a, c = a;
+	b.pop(), b.pop();
+	c.merge(b);
+	c.merge(c);
+	a = a;
+	b = c;
+	c.push("-");
+	std::cout << a.size() << " " << a.top() << " " << b.size() << " " << b.top() << " " << c.top() << std::endl;
+	while (!b.empty()) {
+		std::cout << b.top();
+		b.pop();
+	}
+	std::cout << std::endl;
+	try {b.pop(); std::cout << "WA" << std::endl;} catch (sjtu::container_is_empty) {}
+	try {b.top(); std::cout << "WA" << std::endl;} catch (sjtu::container_is_empty) {}
+	sjtu::persistent_priority_queue<int> *p = new sjtu::persistent_priority_queue<int>;
+	for (int i = 0; i < 200000; ++i) p->push(i);
+	sjtu::persistent_priority_queue<int> q = *p;
+	p->pop();
+	delete p;
+	std::cout << q.size() << " " << q.top() << std::endl;
+}
+
+int main()
+{
+	TestVersions();
+	TestCopyAndAssign();
+	return 0;
+}
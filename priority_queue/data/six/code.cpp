@@ -0,0 +1,65 @@
+#include <iostream>
+#include <queue>
+#include <vector>
+#include <cstdio>
+
+#include "priority_queue.hpp"
+
+int last = 233;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+void TestRangeConstructor()
+{
+	std::cout << "Testing range constructor..." << std::endl;
+	std::vector<int> a;
+	for (int i = 0; i < 100000; ++i) a.push_back(Rand());
+	sjtu::priority_queue<int> pq(a.begin(), a.end());
+	std::priority_queue<int> std_pq(a.begin(), a.end());
+	std::cout << pq.size() << std::endl;
+	bool ok = true;
+	while (!std_pq.empty()) {
+		if (pq.top() != std_pq.top()) ok = false;
+		pq.pop(), std_pq.pop();
+	}
+	std::cout << (ok && pq.empty() ? "OK" : "WA") << std::endl;
+	int b[] = {3, 1, 4, 1, 5, 9, 2, 6};
+	sjtu::priority_queue<int, std::greater<int>> small(b, b + 8);
+	while (!small.empty()) {
+		std::cout << small.top() << " ";
+		small.pop();
+	}
+	std::cout << std::endl;
+	sjtu::priority_queue<int> none(b, b);
+	std::cout << none.size() << std::endl;
+}
+
+void TestPushRange()
+{
+	std::cout << "Testing push_range..." << std::endl;
+	sjtu::priority_queue<long long> pq;
+	std::priority_queue<long long> std_pq;
+	bool ok = true;
+	for (int round = 0; round < 100; ++round) {
+		std::vector<long long> a;
+		for (int i = Rand() % 1000; i > 0; --i) a.push_back(Rand());
+		pq.push_range(a.begin(), a.end());
+		for (auto x : a) std_pq.push(x);
+		for (int i = Rand() % 500; i > 0 && !std_pq.empty(); --i) {
+			if (pq.top() != std_pq.top()) ok = false;
+			pq.pop(), std_pq.pop();
+		}
+		if (pq.size() != std_pq.size()) ok = false;
+	}
+	std::cout << pq.size() << std::endl;
+	std::cout << (ok ? "OK" : "WA") << std::endl;
+}
+
+int main()
+{
+	TestRangeConstructor();
+	TestPushRange();
+	return 0;
+}
@@ -0,0 +1,106 @@
+#include <iostream>
+#include <queue>
+#include <vector>
+#include <cstdio>
+#include <iterator>
+
+#include "priority_queue.hpp"
+
+int last = 4242;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+struct Fuse {}; // what Sink throws
+
+struct Sink { // an output iterator that throws on the write after limit
+	std::vector<int> *to; int limit;
+	Sink &operator*() {return *this;}
+	Sink &operator++() {return *this;}
+	Sink operator++(int) {return *this;}
+	Sink &operator=(int x) {
+		if ((int)to->size() == limit) throw Fuse();
+		to->push_back(x);
+		return *this;
+	}
+};
+
+void TestPopN()
+{
+	std::cout << "Testing pop_n..." << std::endl;
+	sjtu::priority_queue<int> pq;
+	std::priority_queue<int> std_pq;
+	bool ok = true;
+	for (int round = 0; round < 200; ++round) {
+		std::vector<int> a;
+		for (int i = Rand() % 500; i > 0; --i) a.push_back(Rand() % 10000);
+		if (round & 1) pq.push_n(a.begin(), a.end());
+		else for (auto x : a) pq.push(x);
+		for (auto x : a) std_pq.push(x);
+		std::vector<int> b;
+		size_t k = round % 10 == 0 ? 0 : Rand() % (pq.size() + 1);
+		pq.pop_n(k, std::back_inserter(b));
+		if (b.size() != k || pq.size() != std_pq.size() - k) ok = false;
+		for (size_t i = 0; i < k; ++i) {
+			if (b[i] != std_pq.top()) ok = false;
+			std_pq.pop();
+		}
+		if (!pq.empty() && pq.top() != std_pq.top()) ok = false;
+	}
+	std::cout << pq.size() << std::endl;
+	try {
+		pq.pop_n(pq.size() + 1, std::ostream_iterator<int>(std::cout, " "));
+		ok = false;
+	} catch (sjtu::container_is_empty) {}
+	if (pq.size() != std_pq.size()) ok = false;
+	std::vector<int> b(pq.size());
+	pq.pop_n(pq.size(), b.begin()); // all of it
+	for (size_t i = 0; i < b.size(); ++i) {
+		if (b[i] != std_pq.top()) ok = false;
+		std_pq.pop();
+	}
+	std::cout << (ok && pq.empty() && std_pq.empty() ? "OK" : "WA") << std::endl;
+	sjtu::priority_queue<int> none;
+	none.pop_n(0, b.begin());
+	try {none.pop_n(1, b.begin()); std::cout << "WA" << std::endl;} catch (sjtu::container_is_empty) {}
+}
+
+void TestPopNThrow()
+{
+	std::cout << "Testing pop_n with a throwing output..." << std::endl;
+	bool ok = true;
+	for (int round = 0; round < 100; ++round) {
+		sjtu::priority_queue<int> pq;
+		std::priority_queue<int> std_pq;
+		for (int i = 0; i < 1000; ++i) {
+			int x = Rand() % 300; // many equal elements
+			pq.push(x), std_pq.push(x);
+		}
+		std::vector<int> b;
+		int limit = Rand() % 500;
+		try {
+			pq.pop_n(800, Sink{&b, limit});
+			ok = false;
+		} catch (Fuse) {}
+		// what was written is gone, in order, and the rest is all still there
+		if ((int)b.size() != limit || pq.size() != 1000 - b.size()) ok = false;
+		for (auto x : b) {
+			if (x != std_pq.top()) ok = false;
+			std_pq.pop();
+		}
+		while (!std_pq.empty()) {
+			if (pq.empty() || pq.top() != std_pq.top()) {ok = false; break;}
+			pq.pop(), std_pq.pop();
+		}
+		if (!pq.empty()) ok = false;
+	}
+	std::cout << (ok ? "OK" : "WA") << std::endl;
+}
+
+int main()
+{
+	TestPopN();
+	TestPopNThrow();
+	return 0;
+}
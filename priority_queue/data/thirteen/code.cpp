@@ -0,0 +1,86 @@
+#include <iostream>
+#include <vector>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <atomic>
+
+#include "multi_queue.hpp"
+
+int last = 14142;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+void TestOneThread()
+{
+	std::cout << "Testing one thread..." << std::endl;
+	sjtu::multi_queue<int> q(1, 4);
+	const int n = 100000;
+	std::vector<int> a;
+	for (int i = 0; i < n; ++i) {
+		if (i % 3 == 0) q.push(i);
+		else if (i % 3 == 1) {int x = i; q.push(std::move(x));}
+		else a.push_back(i);
+		if (a.size() == 500) q.push_range(a.begin(), a.end()), a.clear();
+	}
+	q.push_range(a.begin(), a.end());
+	q.push_range(a.begin(), a.begin());
+	std::cout << q.size() << std::endl;
+	// every element once, whichever order the heaps give them in
+	std::vector<int> seen(n);
+	bool ok = true;
+	long long sum = 0;
+	for (int i = 0; i < n; ++i) {
+		int x;
+		if (i & 1) x = q.pop();
+		else if (!q.try_pop(x)) {ok = false; break;}
+		if (x < 0 || x >= n || seen[x]++) ok = false;
+		sum += x;
+	}
+	int x;
+	if (q.try_pop(x) || !q.empty()) ok = false;
+	try {q.pop(); ok = false;} catch (sjtu::container_is_empty) {}
+	std::cout << (ok && sum == (long long)n * (n - 1) / 2 ? "OK" : "WA") << std::endl;
+	sjtu::multi_queue<std::string> s(2);
+	s.push("b"), s.push("a"), s.push("c");
+	std::string t = s.pop();
+	s.pop(), s.pop();
+	std::cout << (s.empty() && t.size() == 1 ? "OK" : "WA") << std::endl;
+}
+
+void TestThreads()
+{
+	std::cout << "Testing threads..." << std::endl;
+	const int p = 4, per = 50000;
+	sjtu::multi_queue<int> q(p);
+	std::vector<std::atomic<int>> seen(p * per);
+	for (auto &c : seen) c = 0;
+	std::atomic<int> popped(0);
+	std::vector<std::thread> ts;
+	for (int t = 0; t < p; ++t) ts.emplace_back([&, t] {
+		// each thread pushes its own block, popping now and then as it goes
+		for (int i = 0; i < per; ++i) {
+			q.push(t * per + i);
+			int x;
+			if (i % 3 == 0 && q.try_pop(x)) seen[x]++, popped++;
+		}
+	});
+	for (auto &t : ts) t.join();
+	ts.clear();
+	for (int t = 0; t < p; ++t) ts.emplace_back([&] {
+		for (int x; q.try_pop(x); ) seen[x]++, popped++;
+	});
+	for (auto &t : ts) t.join();
+	bool ok = popped == p * per && q.empty();
+	for (auto &c : seen) if (c != 1) ok = false;
+	std::cout << (ok ? "OK" : "WA") << std::endl;
+}
+
+int main()
+{
+	TestOneThread();
+	TestThreads();
+	return 0;
+}
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <queue>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <functional>
+#include <dirent.h>
+#include <unistd.h>
+
+#include "external_priority_queue.hpp"
+
+int last = 27182;
+
+int Rand() {
+	return last = (325LL * last + 2336) % 1000007;
+}
+
+int Files(const std::string &dir) { // the run files in dir
+	int n = 0;
+	DIR *d = opendir(dir.c_str());
+	while (dirent *e = readdir(d)) if (std::string(e->d_name).compare(0, 8, "sjtu_pq_") == 0) n++;
+	closedir(d);
+	return n;
+}
+
+struct Item {
+	int k; double w;
+	bool operator<(const Item &b) const {return k < b.k;}
+};
+
+void TestSpill(const std::string &dir)
+{
+	std::cout << "Testing spills..." << std::endl;
+	bool ok = true, spilled = false;
+	{
+		sjtu::external_priority_queue<int> pq(1 << 16, dir); // a 64KB budget: a spill every thousand or so
+		std::priority_queue<int> std_pq;
+		for (int i = 0; i < 100000; ++i) {
+			if (Rand() % 4 || std_pq.empty()) {
+				int x = Rand() % 100000;
+				pq.push(x), std_pq.push(x);
+			}
+			else pq.pop(), std_pq.pop();
+			if (pq.size() != std_pq.size() || pq.top() != std_pq.top()) ok = false;
+			if (i % 10000 == 0 && Files(dir)) spilled = true;
+		}
+		std::cout << pq.size() << std::endl;
+		while (!std_pq.empty()) {
+			if (pq.top() != std_pq.top()) ok = false;
+			pq.pop(), std_pq.pop();
+		}
+		if (!pq.empty() || Files(dir)) ok = false; // every run read to its end is gone
+		try {pq.top(); ok = false;} catch (sjtu::container_is_empty) {}
+		try {pq.pop(); ok = false;} catch (sjtu::container_is_empty) {}
+	}
+	std::cout << (ok && spilled ? "OK" : "WA") << std::endl;
+}
+
+void TestTwoQueues(const std::string &dir)
+{
+	std::cout << "Testing two queues in one directory..." << std::endl;
+	bool ok = true;
+	{
+		sjtu::external_priority_queue<Item> a(1 << 16, dir);
+		sjtu::external_priority_queue<int, std::greater<int>> b(1 << 16, dir);
+		std::priority_queue<Item> std_a;
+		std::priority_queue<int, std::vector<int>, std::greater<int>> std_b;
+		for (int i = 0; i < 30000; ++i) {
+			Item x = {Rand() % 1000, i * 0.5};
+			int y = Rand();
+			a.push(x), std_a.push(x);
+			b.push(y), std_b.push(y);
+		}
+		for (int i = 0; i < 20000; ++i) {
+			if (a.top().k != std_a.top().k || b.top() != std_b.top()) ok = false;
+			a.pop(), std_a.pop();
+			b.pop(), std_b.pop();
+		}
+		std::cout << a.size() << " " << b.size() << std::endl;
+		if (!Files(dir)) ok = false;
+	} // left with elements on disk: the files go with the queues
+	std::cout << (ok && !Files(dir) ? "OK" : "WA") << std::endl;
+}
+
+int main()
+{
+	char dir[] = "/tmp/sjtu_pq_test_XXXXXX";
+	if (!mkdtemp(dir)) return 1;
+	TestSpill(dir);
+	TestTwoQueues(dir);
+	std::cout << rmdir(dir) << std::endl; // 0: nothing left behind
+	return 0;
+}
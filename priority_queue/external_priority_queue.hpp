@@ -0,0 +1,204 @@
+#ifndef SJTU_EXTERNAL_PRIORITY_QUEUE_HPP
+#define SJTU_EXTERNAL_PRIORITY_QUEUE_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <unistd.h>
+#include "priority_queue.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+/**
+ * a priority queue that spills to disk when it outgrows its memory budget.
+ * new elements go to an in-memory skew heap. when the heap is full it is
+ * written out in pop order as a sorted run file, and the runs are read back
+ * sequentially through small buffers, merged by a k-way merge heap of their
+ * heads. when there are too many runs for their buffers to fit the budget,
+ * all runs are merged into one.
+ * T is written to disk byte by byte, so it must be trivially copyable.
+ * run files are made by mkstemp and closed through <unistd.h>, so this
+ * header builds on POSIX systems only.
+ */
+template<typename T, class Compare = std::less<T>>
+class external_priority_queue {
+	static_assert(std::is_trivially_copyable<T>::value, "external_priority_queue stores T as raw bytes");
+private:
+	struct run {
+		FILE *f; std::string name;
+		T *buf; size_t pos, len, left; // left: elements still on disk
+	};
+
+	struct head {
+		T v; size_t id;
+	};
+
+	struct head_compare {
+		Compare c;
+		bool operator()(const head &a, const head &b) {return c(a.v, b.v);}
+	};
+
+	static const size_t blk = (1 << 16) / sizeof(T) + 1; // elements per i/o buffer
+
+	priority_queue<T, Compare> q; size_t qcap;
+	priority_queue<head, head_compare> heads;
+	run **runs; size_t nruns, fanin;
+	size_t sz;
+	std::string dir;
+	mutable Compare cmp;
+
+	run *open_run() { // a new file, under a name no other queue or process holds
+		run *r = new run;
+		r->name = dir + "/sjtu_pq_XXXXXX";
+		int fd = mkstemp(&r->name[0]);
+		if (fd < 0) {delete r; throw runtime_error();}
+		r->f = fdopen(fd, "w+b");
+		if (!r->f) {
+			close(fd);
+			remove(r->name.c_str());
+			delete r;
+			throw runtime_error();
+		}
+		r->buf = (T *)operator new(sizeof(T) * blk);
+		r->pos = r->len = r->left = 0;
+		return r;
+	}
+
+	void close_run(size_t id) {
+		run *r = runs[id];
+		fclose(r->f);
+		remove(r->name.c_str());
+		operator delete(r->buf);
+		delete r;
+		runs[id] = NULL;
+	}
+
+	void write(run *r, const T &v) {
+		r->buf[r->len++] = v;
+		r->left++;
+		if (r->len == blk) flush(r);
+	}
+
+	void flush(run *r) {
+		if (r->len && fwrite(r->buf, sizeof(T), r->len, r->f) != r->len) throw runtime_error();
+		r->len = 0;
+	}
+
+	bool next(size_t id, T &v) { // read the next element of a run, sequentially
+		run *r = runs[id];
+		if (r->pos == r->len) {
+			if (!r->left) return false;
+			r->len = fread(r->buf, sizeof(T), r->left < blk ? r->left : blk, r->f);
+			if (!r->len) throw runtime_error();
+			r->left -= r->len;
+			r->pos = 0;
+		}
+		v = r->buf[r->pos++];
+		return true;
+	}
+
+	void add_run(run *r) { // r is written: rewind it and enter its first element into the merge
+		flush(r);
+		rewind(r->f);
+		size_t id = 0;
+		while (id < nruns && runs[id]) id++;
+		if (id == nruns) nruns++;
+		runs[id] = r;
+		head h; h.id = id;
+		if (next(id, h.v)) heads.push(h);
+		else close_run(id);
+	}
+
+	void advance(size_t id) {
+		head h; h.id = id;
+		if (next(id, h.v)) heads.push(h);
+		else close_run(id);
+	}
+
+	void spill() {
+		if (heads.size() + 1 >= fanin) merge_runs();
+		run *r = open_run();
+		while (!q.empty()) write(r, q.pop_value());
+		add_run(r);
+	}
+
+	void merge_runs() {
+		run *r = open_run();
+		while (!heads.empty()) {
+			head h = heads.pop_value();
+			write(r, h.v);
+			advance(h.id);
+		}
+		nruns = 0;
+		add_run(r);
+	}
+
+	bool from_heap() const { // whether the top is in the in-memory heap
+		return !q.empty() && (heads.empty() || !cmp(q.top(), heads.top().v));
+	}
+
+public:
+	/**
+	 * memory: the budget in bytes, shared by the in-memory heap and the run buffers.
+	 * directory: where run files are created; it should be on a local disk.
+	 */
+	explicit external_priority_queue(size_t memory, const std::string &directory = ".", const Compare &c = Compare())
+		: q(c), heads(head_compare{c}), dir(directory), cmp(c) {
+		// a heap node costs the element and two pointers, plus malloc overhead
+		qcap = memory / 2 / (sizeof(T) + 4 * sizeof(void *));
+		if (qcap < 1) qcap = 1;
+		fanin = memory / 2 / (sizeof(T) * blk);
+		if (fanin < 2) fanin = 2;
+		runs = new run*[fanin + 1];
+		nruns = sz = 0;
+	}
+	external_priority_queue(const external_priority_queue &) = delete;
+	external_priority_queue &operator=(const external_priority_queue &) = delete;
+	~external_priority_queue() {
+		for (size_t i = 0; i < nruns; i++) if (runs[i]) close_run(i);
+		delete [] runs;
+	}
+	/**
+	 * get the top of the queue.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	const T & top() const {
+		if (!sz) throw container_is_empty();
+		return from_heap() ? q.top() : heads.top().v;
+	}
+	/**
+	 * push new element. it may write the in-memory heap to disk.
+	 */
+	void push(const T &e) {
+		if (q.size() == qcap) spill();
+		q.push(e);
+		sz++;
+	}
+	/**
+	 * delete the top element.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	void pop() {
+		if (!sz) throw container_is_empty();
+		if (from_heap()) q.pop();
+		else advance(heads.pop_value().id);
+		sz--;
+	}
+	size_t size() const {
+		return sz;
+	}
+	bool empty() const {
+		return sz == 0;
+	}
+};
+
+template<typename T, class Compare>
+const size_t external_priority_queue<T, Compare>::blk;
+
+}
+
+#endif
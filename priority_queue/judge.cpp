@@ -9,7 +9,7 @@ typedef long double LD;
 #define read(a) scanf("%d", &a)
 
 
-string name[] = {"one", "two", "three", "four", "five", "six", "seven", "eight"};
+string name[] = {"one", "two", "three", "four", "five", "six", "seven", "eight", "nine", "ten", "eleven", "twelve", "thirteen"};
 
 int main(int argc, char ** argv)  {
 	for (auto i : name) {
@@ -0,0 +1,193 @@
+#ifndef SJTU_MINMAX_HEAP_HPP
+#define SJTU_MINMAX_HEAP_HPP
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <utility>
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+/**
+ * a double-ended priority queue: a min-max heap in an array.
+ * nodes on even levels are no greater than their descendants and nodes on
+ * odd levels are no less, so both ends are found at the top two levels.
+ * "min" and "max" are in the order of Compare.
+ */
+template<typename T, class Compare = std::less<T>>
+class minmax_heap {
+private:
+	T *a; size_t sz, cap;
+	Compare cmp;
+
+	static bool on_min_level(size_t i) {
+		int lv = 0;
+		for (++i; i > 1; i >>= 1) lv++;
+		return !(lv & 1);
+	}
+
+	bool better(size_t i, size_t j, bool mn) { // a[i] goes above a[j] on a min (or max) level
+		return mn ? cmp(a[i], a[j]) : cmp(a[j], a[i]);
+	}
+
+	void exchange(size_t i, size_t j) {
+		T x(std::move(a[i])); a[i] = std::move(a[j]); a[j] = std::move(x);
+	}
+
+	void bubble_up(size_t i) {
+		if (!i) return;
+		size_t p = (i - 1) / 2;
+		bool mn = on_min_level(i);
+		if (better(p, i, mn)) {
+			exchange(i, p);
+			i = p; mn = !mn;
+		}
+		while (i > 2) {
+			size_t g = ((i - 1) / 2 - 1) / 2;
+			if (!better(i, g, mn)) break;
+			exchange(i, g);
+			i = g;
+		}
+	}
+
+	void trickle_down(size_t i) {
+		bool mn = on_min_level(i);
+		for (;;) {
+			size_t c = 2 * i + 1, m = c;
+			if (c >= sz) return;
+			// the best of the (up to) two children and four grandchildren
+			if (c + 1 < sz && better(c + 1, m, mn)) m = c + 1;
+			for (size_t g = 2 * c + 1; g < sz && g <= 2 * c + 4; g++)
+				if (better(g, m, mn)) m = g;
+			if (!better(m, i, mn)) return;
+			exchange(m, i);
+			if (m <= c + 1) return; // a child: nothing below it can be out of place
+			size_t p = (m - 1) / 2;
+			if (better(p, m, mn)) exchange(m, p);
+			i = m;
+		}
+	}
+
+	size_t max_index() const {
+		if (sz < 3) return sz - 1;
+		return cmp(a[1], a[2]) ? 2 : 1;
+	}
+
+	void reserve(size_t n) {
+		if (n <= cap) return;
+		size_t c = cap ? cap : 16;
+		while (c < n) c <<= 1;
+		T *b = (T *)operator new(sizeof(T) * c);
+		for (size_t i = 0; i < sz; i++) {
+			new(b + i) T(std::move(a[i]));
+			a[i].~T();
+		}
+		operator delete(a);
+		a = b; cap = c;
+	}
+
+	void free_clr() {
+		for (size_t i = 0; i < sz; i++) a[i].~T();
+		operator delete(a);
+		a = NULL; sz = cap = 0;
+	}
+
+	void pop_at(size_t i) {
+		if (i != --sz) a[i] = std::move(a[sz]);
+		a[sz].~T();
+		if (i < sz) trickle_down(i);
+	}
+
+public:
+	explicit minmax_heap(const Compare &c = Compare()) : cmp(c) {a = NULL; sz = cap = 0;}
+	minmax_heap(const minmax_heap &other) : cmp(other.cmp) {
+		a = NULL; sz = cap = 0;
+		reserve(other.sz);
+		for (; sz < other.sz; sz++) new(a + sz) T(other.a[sz]);
+	}
+	~minmax_heap() {free_clr();}
+	minmax_heap &operator=(const minmax_heap &other) {
+		if (this == &other) return *this;
+		free_clr();
+		cmp = other.cmp;
+		reserve(other.sz);
+		for (; sz < other.sz; sz++) new(a + sz) T(other.a[sz]);
+		return *this;
+	}
+	/**
+	 * the least element.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	const T & top_min() const {
+		if (sz) return a[0];
+		else throw container_is_empty();
+	}
+	/**
+	 * the greatest element.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	const T & top_max() const {
+		if (sz) return a[max_index()];
+		else throw container_is_empty();
+	}
+	template <class... Args>
+	void emplace(Args&&... args) {
+		reserve(sz + 1);
+		new(a + sz) T(std::forward<Args>(args)...);
+		bubble_up(sz++);
+	}
+	void push(const T &e) {emplace(e);}
+	void push(T &&e) {emplace(std::move(e));}
+	/**
+	 * delete the least element.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	void pop_min() {
+		if (!sz) throw container_is_empty();
+		pop_at(0);
+	}
+	/**
+	 * delete the greatest element.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	void pop_max() {
+		if (!sz) throw container_is_empty();
+		pop_at(max_index());
+	}
+	size_t size() const {
+		return sz;
+	}
+	bool empty() const {
+		return sz == 0;
+	}
+	/**
+	 * move all elements of other into this, leaving other empty.
+	 * a small other is pushed one by one; otherwise the arrays are
+	 * concatenated and the heap is rebuilt bottom-up in O(n + m).
+	 */
+	void merge(minmax_heap &other) {
+		if (this == &other) return;
+		if (sz < other.sz) {
+			std::swap(a, other.a); std::swap(sz, other.sz); std::swap(cap, other.cap);
+		}
+		size_t lg = 1;
+		for (size_t n = sz + other.sz; n > 1; n >>= 1) lg++;
+		reserve(sz + other.sz);
+		if (other.sz * lg < sz) {
+			for (size_t i = 0; i < other.sz; i++) {
+				new(a + sz) T(std::move(other.a[i]));
+				bubble_up(sz++);
+			}
+		}
+		else {
+			for (size_t i = 0; i < other.sz; i++) new(a + sz++) T(std::move(other.a[i]));
+			for (size_t i = sz / 2; i-- > 0; ) trickle_down(i);
+		}
+		other.free_clr();
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef SJTU_MULTI_QUEUE_HPP
+#define SJTU_MULTI_QUEUE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include "priority_queue.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+/**
+ * a relaxed concurrent priority queue (MultiQueue).
+ * it keeps c * p skew heaps, each behind its own lock, for p threads.
+ * push goes to a random heap; pop locks two random heaps and pops the
+ * better of their tops. the popped element is therefore only close to the
+ * global top: a larger c means less contention but larger rank errors.
+ * every member function may be called from several threads at once.
+ */
+template<typename T, class Compare = std::less<T>>
+class multi_queue {
+private:
+	struct sub {
+		std::mutex m;
+		priority_queue<T, Compare> q;
+		char pad[64]; // keep the locks of neighbouring heaps off one cache line
+	};
+
+	sub *qs; size_t n;
+	Compare cmp;
+
+	static size_t rnd() { // xorshift, one state per thread
+		static thread_local size_t s = 0;
+		if (!s) s = (size_t)&s | 1;
+		s ^= s << 13; s ^= s >> 7; s ^= s << 17;
+		return s;
+	}
+
+	sub *lock_any() {
+		for (;;) {
+			sub *x = qs + rnd() % n;
+			if (x->m.try_lock()) return x;
+		}
+	}
+
+	bool pop_scan(T &out) { // the random choices kept missing, look at every heap
+		for (size_t i = 0; i < n; i++) {
+			std::lock_guard<std::mutex> g(qs[i].m);
+			if (!qs[i].q.empty()) {
+				out = qs[i].q.pop_value();
+				return true;
+			}
+		}
+		return false;
+	}
+
+public:
+	/**
+	 * threads: the number of worker threads p.
+	 * c: heaps per thread, the relaxation knob. it should be at least 2.
+	 */
+	explicit multi_queue(size_t threads, size_t c = 2, const Compare &comp = Compare()) : cmp(comp) {
+		n = threads * c;
+		if (n < 2) n = 2;
+		qs = new sub[n];
+		for (size_t i = 0; i < n; i++) qs[i].q = priority_queue<T, Compare>(cmp);
+	}
+	multi_queue(const multi_queue &) = delete;
+	multi_queue &operator=(const multi_queue &) = delete;
+	~multi_queue() {delete [] qs;}
+	/**
+	 * push new element to a random heap.
+	 */
+	void push(const T &e) {
+		sub *x = lock_any();
+		x->q.push(e);
+		x->m.unlock();
+	}
+	void push(T &&e) {
+		sub *x = lock_any();
+		x->q.push(std::move(e));
+		x->m.unlock();
+	}
+	/**
+	 * batched insert: all of [first, last) goes to one heap under one lock.
+	 */
+	template <class InputIterator>
+	void push_range(InputIterator first, InputIterator last) {
+		sub *x = lock_any();
+		x->q.push_range(first, last);
+		x->m.unlock();
+	}
+	/**
+	 * pop an element close to the top into out.
+	 * @return false if every heap was found empty.
+	 */
+	bool try_pop(T &out) {
+		for (size_t tries = 0; tries < 4 * n; ) {
+			sub *x = qs + rnd() % n, *y = qs + rnd() % n;
+			if (x == y) continue;
+			if (!x->m.try_lock()) continue;
+			if (!y->m.try_lock()) {x->m.unlock(); continue;}
+			if (x->q.empty() || (!y->q.empty() && cmp(x->q.top(), y->q.top()))) swap(x, y);
+			bool ok = !x->q.empty();
+			if (ok) out = x->q.pop_value();
+			y->m.unlock();
+			x->m.unlock();
+			if (ok) return true;
+			tries++;
+		}
+		return pop_scan(out);
+	}
+	/**
+	 * delete and return an element close to the top.
+	 * throw container_is_empty if every heap was found empty.
+	 */
+	T pop() {
+		T ret;
+		if (!try_pop(ret)) throw container_is_empty();
+		return ret;
+	}
+	/**
+	 * the number of elements. it is exact only when no other thread is working.
+	 */
+	size_t size() const {
+		size_t ret = 0;
+		for (size_t i = 0; i < n; i++) {
+			std::lock_guard<std::mutex> g(qs[i].m);
+			ret += qs[i].q.size();
+		}
+		return ret;
+	}
+	bool empty() const {
+		return size() == 0;
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef SJTU_PERSISTENT_PRIORITY_QUEUE_HPP
+#define SJTU_PERSISTENT_PRIORITY_QUEUE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+/**
+ * a priority queue whose versions share structure.
+ * it is a leftist heap with reference-counted nodes: copying is O(1), and
+ * push, pop and merge copy only the O(logn) right spine they touch, so a
+ * copy taken earlier never sees later changes.
+ * nodes are never written after they are built, except for the counters,
+ * which are not atomic: do not share versions across threads.
+ */
+template<typename T, class Compare = std::less<T>>
+class persistent_priority_queue {
+private:
+	struct Node {
+		Node *l, *r; size_t cnt; int dis; T v;
+		template <class... Args>
+		Node (Args&&... args) : v(std::forward<Args>(args)...) {
+			l = r = NULL; cnt = 1; dis = 1;
+		}
+	};
+
+	Node *rt; size_t sz;
+	Compare cmp;
+
+	static int dis(Node *x) {return x ? x->dis : 0;}
+
+	static Node *ref(Node *x) {
+		if (x) x->cnt++;
+		return x;
+	}
+
+	static void release(Node *x) { // drop one reference, without recursion
+		while (x && !--x->cnt) {
+			Node *y = x->l;
+			if (!y) {
+				y = x->r;
+				delete x;
+				x = y;
+			}
+			else if (y->cnt > 1) {
+				y->cnt--;
+				x->l = NULL; x->cnt = 1;
+			}
+			else { // y dies as well, hang x on it and go on with y
+				x->l = y->r;
+				y->r = x; x->cnt = 1;
+				x = y;
+			}
+		}
+	}
+
+	Node *mer(Node *x, Node *y) { // a new reference to the merged heap, x and y untouched
+		if (!x) return ref(y);
+		if (!y) return ref(x);
+		if (cmp(x->v, y->v)) {Node *t = x; x = y; y = t;}
+		Node *z = new Node(x->v);
+		z->l = ref(x->l);
+		z->r = mer(x->r, y);
+		if (dis(z->l) < dis(z->r)) {Node *t = z->l; z->l = z->r; z->r = t;}
+		z->dis = dis(z->r) + 1;
+		return z;
+	}
+
+public:
+	explicit persistent_priority_queue(const Compare &c = Compare()) : cmp(c) {rt = NULL; sz = 0;}
+	/**
+	 * O(1): the new version shares every node with other.
+	 */
+	persistent_priority_queue(const persistent_priority_queue &other) : cmp(other.cmp) {
+		rt = ref(other.rt);
+		sz = other.sz;
+	}
+	~persistent_priority_queue() {release(rt);}
+	persistent_priority_queue &operator=(const persistent_priority_queue &other) {
+		Node *x = ref(other.rt);
+		release(rt);
+		rt = x; sz = other.sz; cmp = other.cmp;
+		return *this;
+	}
+	/**
+	 * get the top of the queue.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	const T & top() const {
+		if (sz) return rt->v;
+		else throw container_is_empty();
+	}
+	/**
+	 * push new element, in O(logn).
+	 */
+	template <class... Args>
+	void emplace(Args&&... args) {
+		Node *x = new Node(std::forward<Args>(args)...), *y = mer(rt, x);
+		release(x);
+		release(rt);
+		rt = y;
+		sz++;
+	}
+	void push(const T &e) {emplace(e);}
+	void push(T &&e) {emplace(std::move(e));}
+	/**
+	 * delete the top element, in O(logn).
+	 * throw container_is_empty if empty() returns true;
+	 */
+	void pop() {
+		if (!sz) throw container_is_empty();
+		Node *x = mer(rt->l, rt->r);
+		release(rt);
+		rt = x;
+		sz--;
+	}
+	size_t size() const {
+		return sz;
+	}
+	bool empty() const {
+		return sz == 0;
+	}
+	/**
+	 * merge other into this version in O(logn). other is left unchanged.
+	 */
+	void merge(const persistent_priority_queue &other) {
+		Node *x = mer(rt, other.rt);
+		release(rt);
+		rt = x;
+		sz += other.sz;
+	}
+};
+
+}
+
+#endif
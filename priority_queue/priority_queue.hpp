@@ -3,33 +3,70 @@
 
 #include <cstddef>
 #include <functional>
+#include <type_traits>
+#include <utility>
 #include "exceptions.hpp"
 
 namespace sjtu {
 template <class T> void swap(T &a, T &b) {
 	if (&a == &b) return;
-	T x = a; a = b; b = x;
+	T x(std::move(a)); a = std::move(b); b = std::move(x);
 }
 
+/**
+ * the default projection of priority_queue: no sort key is cached.
+ */
+struct no_key {};
+
+/**
+ * a cheap sort key computed once at push and stored in the node.
+ * keys are compared with operator<, and the full comparator is only
+ * called when two keys are equal.
+ */
+template <class T, class Projection>
+struct key_cache {
+	typename std::decay<decltype(std::declval<const Projection &>()(std::declval<const T &>()))>::type k;
+	void set(const Projection &p, const T &v) {k = p(v);}
+	template <class Compare>
+	bool less(const key_cache &b, const T &x, const T &y, Compare &cmp) const {
+		return k < b.k || (!(b.k < k) && cmp(x, y));
+	}
+};
+
+template <class T>
+struct key_cache<T, no_key> {
+	void set(const no_key &, const T &) {}
+	template <class Compare>
+	bool less(const key_cache &, const T &x, const T &y, Compare &cmp) const {
+		return cmp(x, y);
+	}
+};
 
 /**
  * a container like std::priority_queue which is a heap internal.
  * it should be based on the vector written by yourself.
+ *
+ * Projection maps an element to a cheap sort key (e.g. an integer prefix).
+ * It must agree with Compare: proj(a) < proj(b) implies Compare()(a, b).
  */
-template<typename T, class Compare = std::less<T>>
+template<typename T, class Compare = std::less<T>, class Projection = no_key>
 class priority_queue {
 private:
-	struct Node {
+	struct Node : key_cache<T, Projection> {
 		Node *l, *r; T v;
-		Node (const T &a) : v(a){
+		template <class... Args>
+		Node (Args&&... args) : v(std::forward<Args>(args)...){
 			l = NULL; r = NULL;
 		}
 	};
 
 	Node *rt; size_t sz;
+	Compare cmp; Projection proj;
 
-	Node *newnode(const T &a) {
-		Node *x = new Node(a);
+	template <class... Args>
+	Node *newnode(Args&&... args) {
+		Node *x = new Node(std::forward<Args>(args)...);
+		x->set(proj, x->v);
 		return x;
 	}
 
@@ -41,9 +78,9 @@ private:
 		delete x;
 	}
 	
-	Node *cp(Node *y) {
+	Node *cp(const Node *y) {
 		if (y) {
-			Node *x = new Node(y->v);
+			Node *x = new Node(*y);
 			x->l = cp(y->l);
 			x->r = cp(y->r);
 			return x;
@@ -54,12 +91,60 @@ private:
 	Node *mer(Node *x, Node *y) {
 		if (!x) return y;
 		if (!y) return x;
-		if (Compare()(x->v, y->v)) swap(x, y);
+		if (lower(x, y)) swap(x, y);
 		swap(x->l, x->r);
 		x->l = mer(x->l, y);
 		return x;
 	}
 
+	template <class InputIterator>
+	Node *build(InputIterator first, InputIterator last, size_t &cnt) { // cnt: the nodes built
+		// slot[k] holds a heap of exactly 2^k nodes, carried like a binary counter,
+		// so every node takes part in O(1) merges of equal-sized heaps on average
+		Node *slot[sizeof(size_t) * 8] = {};
+		try {
+			for (; first != last; ++first, ++cnt) {
+				Node *x = newnode(*first);
+				int k = 0;
+				for (; slot[k]; k++) x = mer(x, slot[k]), slot[k] = NULL;
+				slot[k] = x;
+			}
+		}
+		catch (...) {
+			for (size_t k = 0; k < sizeof(size_t) * 8; k++) del(slot[k]);
+			throw;
+		}
+		Node *x = NULL;
+		for (size_t k = 0; k < sizeof(size_t) * 8; k++) x = mer(x, slot[k]);
+		return x;
+	}
+
+	bool lower(Node *x, Node *y) {
+		return x->less(*y, x->v, y->v, cmp);
+	}
+
+	void sift_down(Node **f, size_t n, size_t i) { // f is a binary heap of nodes
+		for (size_t c; (c = 2 * i + 1) < n; i = c) {
+			if (c + 1 < n && lower(f[c], f[c + 1])) c++;
+			if (!lower(f[i], f[c])) break;
+			swap(f[i], f[c]);
+		}
+	}
+
+	void sift_up(Node **f, size_t i) {
+		for (; i && lower(f[(i - 1) / 2], f[i]); i = (i - 1) / 2) swap(f[i], f[(i - 1) / 2]);
+	}
+
+	Node *mer_all(Node **f, size_t n) { // merge the heaps f[0, n) pairwise
+		while (n > 1) {
+			size_t m = 0;
+			for (size_t i = 0; i + 1 < n; i += 2) f[m++] = mer(f[i], f[i + 1]);
+			if (n & 1) f[m++] = f[n - 1];
+			n = m;
+		}
+		return n ? f[0] : NULL;
+	}
+
 	void free_clr() {
 		del(rt);
 		rt = NULL;
@@ -75,8 +160,18 @@ public:
 	/**
 	 * TODO constructors
 	 */
-	priority_queue() {rt = NULL; sz = 0;}
-	priority_queue(const priority_queue &other) {
+	explicit priority_queue(const Compare &c = Compare(), const Projection &p = Projection())
+		: cmp(c), proj(p) {rt = NULL; sz = 0;}
+	/**
+	 * build the heap from [first, last) in O(n).
+	 */
+	template <class InputIterator>
+	priority_queue(InputIterator first, InputIterator last,
+			const Compare &c = Compare(), const Projection &p = Projection()) : cmp(c), proj(p) {
+		sz = 0;
+		rt = build(first, last, sz);
+	}
+	priority_queue(const priority_queue &other) : cmp(other.cmp), proj(other.proj) {
 		rt = cp(other.rt);		
 		sz = other.sz;
 	}
@@ -90,6 +185,7 @@ public:
 	priority_queue &operator=(const priority_queue &other) {
 		if (this == &other) return *this; 
 		free_clr();
+		cmp = other.cmp; proj = other.proj;
 		rt = cp(other.rt);		
 		sz = other.sz;
 		return *this;
@@ -111,6 +207,35 @@ public:
 		rt = mer(rt, newnode(e));
 		sz++;
 	}
+	void push(T &&e) {
+		rt = mer(rt, newnode(std::move(e)));
+		sz++;
+	}
+	/**
+	 * construct a new element in place from args.
+	 */
+	template <class... Args>
+	void emplace(Args&&... args) {
+		rt = mer(rt, newnode(std::forward<Args>(args)...));
+		sz++;
+	}
+	/**
+	 * push all elements in [first, last).
+	 * a heap of the range is built in O(n) and merged in once.
+	 */
+	template <class InputIterator>
+	void push_range(InputIterator first, InputIterator last) {
+		size_t n = 0;
+		rt = mer(rt, build(first, last, n));
+		sz += n;
+	}
+	/**
+	 * batched push: the same as push_range.
+	 */
+	template <class InputIterator>
+	void push_n(InputIterator first, InputIterator last) {
+		push_range(first, last);
+	}
 	/**
 	 * TODO
 	 * delete the top element.
@@ -123,6 +248,71 @@ public:
 		rt = mer(l, r);
 		sz--;
 	}
+	/**
+	 * delete the top element and return it, moved out of the node.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	T pop_value() {
+		if (!sz) throw container_is_empty();
+		T ret(std::move(rt->v));
+		pop();
+		return ret;
+	}
+	/**
+	 * delete the top k elements, moving them to out in pop order.
+	 * the tree is not merged between pops: the k nodes are taken best-first
+	 * from a small array heap of subtree roots, and the subtrees left over
+	 * are merged back once at the end.
+	 * throw container_is_empty if k > size();
+	 */
+	template <class OutputIterator>
+	OutputIterator pop_n(size_t k, OutputIterator out) {
+		if (k > sz) throw container_is_empty();
+		if (!k) return out;
+		Node **f = new Node*[k + 1];
+		size_t n = 0, i = 0;
+		f[n++] = rt;
+		rt = NULL;
+		try {
+			while (i < k) {
+				// every node not yet written out is in f[0, n), so a throw loses none
+				Node *x = f[0], *l = x->l, *r = x->r;
+				*out++ = std::move(x->v);
+				f[0] = f[--n];
+				size_t m = n;
+				if (l) f[n++] = l;
+				if (r) f[n++] = r;
+				delete x;
+				i++;
+				sift_down(f, m, 0);
+				for (; m < n; m++) sift_up(f, m);
+			}
+		}
+		catch (...) {
+			rt = mer_all(f, n);
+			sz -= i;
+			delete [] f;
+			throw;
+		}
+		rt = mer_all(f, n);
+		sz -= k;
+		delete [] f;
+		return out;
+	}
+	/**
+	 * replace the top element with e, reusing its node.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	template <class U>
+	void replace_top(U &&e) {
+		if (!sz) throw container_is_empty();
+		Node *x = rt;
+		x->v = std::forward<U>(e); // in place first: if it throws, the node is still in the tree
+		rt = mer(x->l, x->r);
+		x->l = x->r = NULL;
+		x->set(proj, x->v);
+		rt = mer(rt, x);
+	}
 	/**
 	 * return the number of the elements.
 	 */